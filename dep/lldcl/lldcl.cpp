@@ -4,6 +4,9 @@
 // based on: https://github.com/llvm/llvm-project/blob/main/lld/unittests/AsLibAll/AllDrivers.cpp
 //           https://github.com/numba/llvmlite/blob/main/ffi/linker.cpp
 
+#include "lldcl.h"
+
+#include <cstring>
 #include <lld/Common/Driver.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -19,6 +22,12 @@ LLD_HAS_DRIVER(mingw)
 
 #define LLD_COFF_ELF_MINGW_DRIVER { {lld::WinLink, &lld::coff::link}, {lld::Gnu, &lld::elf::link}, {lld::MinGW, &lld::mingw::link} }
 
+/*
+ *  lld keeps global state between runs. Once a link reports that it cannot
+ *  run again, every further invocation in this process is refused.
+ */
+static bool can_run_again = true;
+
 extern "C" {
 
 /**
@@ -29,20 +38,30 @@ extern "C" {
  * @return
  */
 int lld_main(int Argc, const char **Argv, const char **outstr) {
+    if (!can_run_again) {
+        *outstr = strdup("lld cannot be invoked again in this process");
+        return 1;
+    }
+
     // StdOut
-    std::string stdout;
-    llvm::raw_string_ostream stdout_stream(stdout);
+    std::string out;
+    llvm::raw_string_ostream stdout_stream(out);
 
     // StdErr
-    std::string stderr;
-    llvm::raw_string_ostream stderr_stream(stderr);
+    std::string err;
+    llvm::raw_string_ostream stderr_stream(err);
 
     // convert arguments
     std::vector<const char *> Args(Argv, Argv + Argc);
 
     lld::Result result = lld::lldMain(Args, stdout_stream, stderr_stream, LLD_COFF_ELF_MINGW_DRIVER);
 
-    *outstr = strdup(stderr.append(stdout).c_str());
+    can_run_again = result.canRunAgain;
+
+    stdout_stream.flush();
+    stderr_stream.flush();
+
+    *outstr = strdup(err.append(out).c_str());
 
     return result.retCode;
 }
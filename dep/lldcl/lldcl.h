@@ -0,0 +1,27 @@
+//
+// C interface to the lld linker library. Lets the compiler written in C
+// run lld within its own process.
+//
+
+#ifndef GEMSTONE_LLDCL_H
+#define GEMSTONE_LLDCL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run lld in-process with the given argument vector.
+ *        The flavor (ELF, COFF, MinGW) is selected from argv[0].
+ * @param Argc number of arguments
+ * @param Argv arguments including the program name
+ * @param outstr captured diagnostics of lld, must be freed with free()
+ * @return exit code of lld
+ */
+int lld_main(int Argc, const char **Argv, const char **outstr);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // GEMSTONE_LLDCL_H
@@ -3,6 +3,7 @@
 #include <ast/ast.h>
 #include <mem/cache.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/log.h>
 
 struct AST_Node_t* AST_new_node(TokenLocation location,
@@ -21,15 +22,48 @@ struct AST_Node_t* AST_new_node(TokenLocation location,
     assert(node != NULL);
 
     // init to discrete state
-    node->parent   = NULL;
-    node->children = mem_new_g_array(MemoryNamespaceAst, sizeof(AST_NODE_PTR));
-    node->kind     = kind;
-    node->value    = value;
-    node->location = location;
+    node->parent            = NULL;
+    node->children.data     = node->inline_children;
+    node->children.len      = 0;
+    node->children.capacity = AST_INLINE_CHILDREN;
+    node->kind              = kind;
+    node->value             = value;
+    node->location          = location;
 
     return node;
 }
 
+// make room for at least one more child
+static void AST_reserve_child(struct AST_Node_t* owner) {
+    if (owner->children.len < owner->children.capacity) {
+        return;
+    }
+
+    const guint capacity = owner->children.capacity * 2;
+
+    if (owner->children.data == owner->inline_children) {
+        owner->children.data =
+          mem_alloc(MemoryNamespaceAst, capacity * sizeof(AST_NODE_PTR));
+
+        if (owner->children.data == NULL) {
+            PANIC("failed to allocate children array of AST node");
+        }
+
+        memcpy(owner->children.data, owner->inline_children,
+               sizeof(owner->inline_children));
+    } else {
+        owner->children.data = mem_realloc(
+          MemoryNamespaceAst, owner->children.data,
+          capacity * sizeof(AST_NODE_PTR));
+
+        if (owner->children.data == NULL) {
+            PANIC("failed to reallocate children array of AST node");
+        }
+    }
+
+    owner->children.capacity = capacity;
+}
+
 static const char* lookup_table[AST_ELEMENT_COUNT] = {"__UNINIT__"};
 
 void AST_init() {
@@ -139,10 +173,6 @@ void AST_push_node(struct AST_Node_t* owner, struct AST_Node_t* child) {
     assert(owner != NULL);
     assert(child != NULL);
 
-    if (owner->children == NULL) {
-        PANIC("failed to allocate children array of AST node");
-    }
-
     owner->location.col_end =
       max(owner->location.col_end, child->location.col_end);
     owner->location.line_end =
@@ -157,22 +187,17 @@ void AST_push_node(struct AST_Node_t* owner, struct AST_Node_t* child) {
         owner->location.file = child->location.file;
     }
 
-    assert(owner->children != NULL);
+    AST_reserve_child(owner);
 
-    g_array_append_val(owner->children, child);
+    owner->children.data[owner->children.len++] = child;
 }
 
 struct AST_Node_t* AST_get_node(struct AST_Node_t* owner, const size_t idx) {
     DEBUG("retrvieng node %d from %p", idx, owner);
     assert(owner != NULL);
-    assert(owner->children != NULL);
-    assert(idx < owner->children->len);
+    assert(idx < owner->children.len);
 
-    if (owner->children == NULL) {
-        PANIC("AST owner node has no children");
-    }
-
-    AST_NODE_PTR child = g_array_index(owner->children, AST_NODE_PTR, idx);
+    AST_NODE_PTR child = owner->children.data[idx];
 
     if (child == NULL) {
         PANIC("child node is NULL");
@@ -184,11 +209,13 @@ struct AST_Node_t* AST_get_node(struct AST_Node_t* owner, const size_t idx) {
 struct AST_Node_t* AST_remove_child(struct AST_Node_t* owner,
                                     const size_t idx) {
     assert(owner != NULL);
-    assert(owner->children != NULL);
-    assert(idx < owner->children->len);
+    assert(idx < owner->children.len);
 
-    AST_NODE_PTR child = g_array_index(owner->children, AST_NODE_PTR, idx);
-    g_array_remove_index(owner->children, idx);
+    AST_NODE_PTR child = owner->children.data[idx];
+
+    owner->children.len--;
+    memmove(owner->children.data + idx, owner->children.data + idx + 1,
+            (owner->children.len - idx) * sizeof(AST_NODE_PTR));
 
     child->parent = NULL;
 
@@ -199,10 +226,9 @@ struct AST_Node_t* AST_detach_child(struct AST_Node_t* owner,
                                     const struct AST_Node_t* child) {
     assert(owner != NULL);
     assert(child != NULL);
-    assert(owner->children != NULL);
 
-    for (size_t i = 0; i < owner->children->len; i++) {
-        if (g_array_index(owner->children, AST_NODE_PTR, i) == child) {
+    for (size_t i = 0; i < owner->children.len; i++) {
+        if (owner->children.data[i] == child) {
             return AST_remove_child(owner, i);
         }
     }
@@ -221,13 +247,14 @@ void AST_delete_node(struct AST_Node_t* node) {
         assert(child == node);
     }
 
-    if (node->children != NULL) {
-        for (size_t i = 0; i < AST_get_child_count(node); i++) {
-            // prevent detach of children node
-            AST_get_node(node, i)->parent = NULL;
-            AST_delete_node(AST_get_node(node, i));
-        }
-        mem_free(node->children);
+    for (size_t i = 0; i < AST_get_child_count(node); i++) {
+        // prevent detach of children node
+        AST_get_node(node, i)->parent = NULL;
+        AST_delete_node(AST_get_node(node, i));
+    }
+
+    if (node->children.data != node->inline_children) {
+        mem_free(node->children.data);
     }
 
     mem_free(node);
@@ -243,9 +270,8 @@ static void AST_visit_nodes_recurse2(struct AST_Node_t* root,
 
     (for_each)(root, depth);
 
-    for (size_t i = 0; i < root->children->len; i++) {
-        AST_visit_nodes_recurse2(g_array_index(root->children, AST_NODE_PTR, i),
-                                 for_each, depth + 1);
+    for (size_t i = 0; i < root->children.len; i++) {
+        AST_visit_nodes_recurse2(root->children.data[i], for_each, depth + 1);
     }
 }
 
@@ -270,13 +296,8 @@ static void AST_fprint_graphviz_node_definition(FILE* stream,
     fprintf(stream, "\tnode%p [label=\"%s\"]\n", (void*) node,
             AST_node_to_string(node));
 
-    if (node->children == NULL) {
-        return;
-    }
-
-    for (size_t i = 0; i < node->children->len; i++) {
-        AST_fprint_graphviz_node_definition(
-          stream, g_array_index(node->children, AST_NODE_PTR, i));
+    for (size_t i = 0; i < node->children.len; i++) {
+        AST_fprint_graphviz_node_definition(stream, node->children.data[i]);
     }
 }
 
@@ -287,12 +308,8 @@ static void AST_fprint_graphviz_node_connection(FILE* stream,
     assert(stream != NULL);
     assert(node != NULL);
 
-    if (node->children == NULL) {
-        return;
-    }
-
-    for (size_t i = 0; i < node->children->len; i++) {
-        AST_NODE_PTR child = g_array_index(node->children, AST_NODE_PTR, i);
+    for (size_t i = 0; i < node->children.len; i++) {
+        AST_NODE_PTR child = node->children.data[i];
         fprintf(stream, "\tnode%p -- node%p\n", (void*) node, (void*) child);
         AST_fprint_graphviz_node_connection(stream, child);
     }
@@ -314,7 +331,7 @@ void AST_fprint_graphviz(FILE* stream, const struct AST_Node_t* root) {
 
 AST_NODE_PTR AST_get_node_by_kind(AST_NODE_PTR owner,
                                   enum AST_SyntaxElement_t kind) {
-    for (size_t i = 0; i < owner->children->len; i++) {
+    for (size_t i = 0; i < owner->children.len; i++) {
         AST_NODE_PTR child = AST_get_node(owner, i);
 
         if (child->kind == kind) {
@@ -329,7 +346,7 @@ void AST_merge_modules(AST_NODE_PTR dst, size_t k, AST_NODE_PTR src) {
     assert(dst != NULL);
     assert(src != NULL);
 
-    size_t elements = src->children->len;
+    size_t elements = src->children.len;
     for (size_t i = 0; i < elements; i++) {
         AST_insert_node(dst, k + i, AST_remove_child(src, 0));
     }
@@ -340,17 +357,23 @@ void AST_insert_node(AST_NODE_PTR owner, size_t idx, AST_NODE_PTR child) {
     assert(owner != NULL);
     assert(child != NULL);
 
-    DEBUG("Reallocating old children array");
+    assert(idx <= owner->children.len);
+
+    AST_reserve_child(owner);
+
+    memmove(owner->children.data + idx + 1, owner->children.data + idx,
+            (owner->children.len - idx) * sizeof(AST_NODE_PTR));
 
-    g_array_insert_val(owner->children, idx, child);
+    owner->children.data[idx] = child;
+    owner->children.len++;
 }
 
 size_t AST_get_child_count(AST_NODE_PTR node) {
-    return node->children->len;
+    return node->children.len;
 }
 
 AST_NODE_PTR AST_get_last_node(AST_NODE_PTR node) {
     assert(node != NULL);
 
-    return g_array_index(node->children, AST_NODE_PTR, node->children->len - 1);
+    return node->children.data[node->children.len - 1];
 }
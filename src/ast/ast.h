@@ -88,6 +88,23 @@ enum AST_SyntaxElement_t {
     AST_ELEMENT_COUNT
 };
 
+// number of children stored inline with their parent node
+#define AST_INLINE_CHILDREN 3
+
+/**
+ * @brief Children of a node. The first AST_INLINE_CHILDREN children are
+ *        stored within the node itself, only nodes with more children
+ *        allocate a separate array.
+ */
+typedef struct AST_Children_t {
+    // points to the inline storage of the node or to an allocated array
+    struct AST_Node_t** data;
+    // number of children
+    guint len;
+    // number of children data can hold
+    guint capacity;
+} AST_Children;
+
 /**
  * @brief A single node which can be joined with other nodes like a graph.
  * Every node can have one ancestor (parent) but multiple (also none) children.
@@ -100,15 +117,17 @@ typedef struct AST_Node_t {
     // parent node that owns this node
     struct AST_Node_t* parent;
 
-    // type of AST node: if, declaration, ...
-    enum AST_SyntaxElement_t kind;
     // optional value: integer literal, string literal, ...
     const char* value;
 
     TokenLocation location;
 
+    // type of AST node: if, declaration, ...
+    enum AST_SyntaxElement_t kind;
+
     // children array
-    GArray* children;
+    AST_Children children;
+    struct AST_Node_t* inline_children[AST_INLINE_CHILDREN];
 } AST_Node;
 
 /**
@@ -135,7 +154,8 @@ const char* AST_node_to_string(const struct AST_Node_t* node);
 /**
  * @brief Create a new node struct on the system heap. Initializes the struct
  * with the given values. All other fields are set to either NULL or 0. No
- * allocation for children array is preformed.
+ * allocation for children array is preformed, the first children are stored
+ * inline.
  *  @attention parameter value can be NULL in case no value can be provided for
  * the node
  * @param kind the type of this node
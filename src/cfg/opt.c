@@ -27,9 +27,14 @@ static void clean(void) {
 }
 
 void parse_options(int argc, char* argv[]) {
-    args = g_hash_table_new(g_str_hash, g_str_equal);
+    if (args != NULL) {
+        // options are replaced for every request of the compile server
+        clean();
+    } else {
+        atexit(clean);
+    }
 
-    atexit(clean);
+    args = g_hash_table_new(g_str_hash, g_str_equal);
 
     for (int i = 0; i < argc; i++) {
         Option* option = mem_alloc(MemoryNamespaceOpt, sizeof(Option));
@@ -90,6 +95,20 @@ GArray* get_non_options_after(const char* command) {
     return array;
 }
 
+static int get_lto_mode_from_str(TargetLTOMode* mode, const char* name) {
+    if (strcmp(name, "none") == 0) {
+        *mode = LTOModeNone;
+    } else if (strcmp(name, "thin") == 0) {
+        *mode = LTOModeThin;
+    } else if (strcmp(name, "full") == 0) {
+        *mode = LTOModeFull;
+    } else {
+        return PROJECT_SEMANTIC_ERR;
+    }
+
+    return PROJECT_OK;
+}
+
 TargetConfig* default_target_config() {
     DEBUG("generating default target config...");
 
@@ -104,11 +123,17 @@ TargetConfig* default_target_config() {
     config->archive_directory  = mem_strdup(MemoryNamespaceOpt, "archive");
     config->output_directory   = mem_strdup(MemoryNamespaceOpt, "bin");
     config->optimization_level = 1;
+    config->opt_pipeline       = NULL;
     config->root_module        = NULL;
     config->link_search_paths =
       mem_new_g_array(MemoryNamespaceOpt, sizeof(char*));
-    config->lld_fatal_warnings = FALSE;
-    config->gsc_fatal_warnings = FALSE;
+    config->lld_fatal_warnings   = FALSE;
+    config->gsc_fatal_warnings   = FALSE;
+    config->separate_compilation = false;
+    config->codegen_shards       = 1;
+    config->lto                  = LTOModeNone;
+    config->keep_intermediates   = false;
+    config->emit_interfaces      = false;
     config->import_paths = mem_new_g_array(MemoryNamespaceOpt, sizeof(char*));
 
     return config;
@@ -141,6 +166,34 @@ TargetConfig* default_target_config_from_args() {
         config->print_ir = true;
     }
 
+    if (is_option_set("separate-compilation")) {
+        config->separate_compilation = true;
+    }
+
+    if (is_option_set("codegen-shards")) {
+        const Option* opt = get_option("codegen-shards");
+
+        if (opt->value != NULL) {
+            char* end   = NULL;
+            long shards = strtol(opt->value, &end, 10);
+
+            if (*end == 0 && shards >= 1 && shards <= G_MAXINT) {
+                config->codegen_shards = (int) shards;
+            } else {
+                print_message(Warning, "Invalid number of codegen shards: %s",
+                              opt->value);
+            }
+        }
+    }
+
+    if (is_option_set("keep-intermediates")) {
+        config->keep_intermediates = true;
+    }
+
+    if (is_option_set("emit-interfaces")) {
+        config->emit_interfaces = true;
+    }
+
     if (is_option_set("mode")) {
         const Option* opt = get_option("mode");
 
@@ -156,6 +209,16 @@ TargetConfig* default_target_config_from_args() {
         }
     }
 
+    if (is_option_set("lto")) {
+        const Option* opt = get_option("lto");
+
+        if (opt->value != NULL
+            && get_lto_mode_from_str(&config->lto, opt->value) != PROJECT_OK) {
+            print_message(Warning, "Invalid link time optimization mode: %s",
+                          opt->value);
+        }
+    }
+
     if (is_option_set("output")) {
         const Option* opt = get_option("output");
 
@@ -172,10 +235,18 @@ TargetConfig* default_target_config_from_args() {
         }
     }
 
-    char* cwd        = g_get_current_dir();
-    char* cached_cwd = mem_strdup(MemoryNamespaceOpt, cwd);
-    g_array_append_val(config->link_search_paths, cached_cwd);
-    free(cwd);
+    if (is_option_set("opt-pipeline")) {
+        const Option* opt = get_option("opt-pipeline");
+
+        if (opt->value != NULL) {
+            config->opt_pipeline =
+              mem_strdup(MemoryNamespaceOpt, (char*) opt->value);
+        }
+    }
+
+    char* cwd = g_get_current_dir();
+    add_search_directory(config->link_search_paths, cwd);
+    g_free(cwd);
 
     if (is_option_set("link-paths")) {
         const Option* opt = get_option("link-paths");
@@ -191,7 +262,8 @@ TargetConfig* default_target_config_from_args() {
                 memcpy(link_path, start, len);
                 link_path[len] = 0;
 
-                g_array_append_val(config->link_search_paths, link_path);
+                add_search_directory(config->link_search_paths, link_path);
+                mem_free(link_path);
 
                 start = end;
             }
@@ -202,7 +274,8 @@ TargetConfig* default_target_config_from_args() {
                 memcpy(link_path, start, len);
                 link_path[len] = 0;
 
-                g_array_append_val(config->link_search_paths, link_path);
+                add_search_directory(config->link_search_paths, link_path);
+                mem_free(link_path);
             }
         }
     }
@@ -222,8 +295,7 @@ TargetConfig* default_target_config_from_args() {
           mem_strdup(MemoryNamespaceOpt, g_array_index(files, char*, 0));
     }
 
-    char* default_import_path = mem_strdup(MemoryNamespaceOpt, ".");
-    g_array_append_val(config->import_paths, default_import_path);
+    add_search_directory(config->import_paths, ".");
 
     if (is_option_set("import-paths")) {
         const Option* opt = get_option("import-paths");
@@ -239,7 +311,8 @@ TargetConfig* default_target_config_from_args() {
                 memcpy(import_path, start, len);
                 import_path[len] = 0;
 
-                g_array_append_val(config->import_paths, import_path);
+                add_search_directory(config->import_paths, import_path);
+                mem_free(import_path);
 
                 start = end;
             }
@@ -250,7 +323,8 @@ TargetConfig* default_target_config_from_args() {
                 memcpy(import_path, start, len);
                 import_path[len] = 0;
 
-                g_array_append_val(config->import_paths, import_path);
+                add_search_directory(config->import_paths, import_path);
+                mem_free(import_path);
             }
         }
     }
@@ -275,6 +349,18 @@ void print_help(void) {
         "application or library",
         "    --output=name         name of output files without extension",
         "    --driver              set binary driver to use",
+        "    --opt-pipeline=passes set a custom LLVM pass pipeline "
+        "(e.g. default<Oz>)",
+        "    --separate-compilation compile every module into its own object "
+        "file",
+        "    --codegen-shards=N    generate code for functions on N threads "
+        "and link the objects",
+        "    --lto=[thin|full]     emit bitcode and optimize across modules "
+        "when linking",
+        "    --keep-intermediates  always write object files to the archive "
+        "directory",
+        "    --emit-interfaces     write module interface files to skip "
+        "parsing unchanged modules",
         "    --link-paths=[paths,] set a list of directories to for libraries "
         "in",
         "    --all-fatal-warnings  treat all warnings as errors",
@@ -288,8 +374,14 @@ void print_help(void) {
         "    --list-targets   print a list of all available targets supported",
         "    --list-driver    print a list of all available binary driver",
         "    --help           print this help dialog",
+        "    --jobs[=N]       build up to N targets in parallel",
+        "    --no-cache       rebuild targets even if they are up to date",
+        "    --server[=socket] serve builds of clients from a warm process",
+        "    --client[=socket] let a running server build, if there is one",
         "    --color-always   always colorize output",
-        "    --print-gc-stats print statistics of the garbage collector"};
+        "    --print-gc-stats print statistics of the garbage collector",
+        "    --time-report    print time and memory spent in each phase",
+        "    --time-trace=file write phases as Chrome trace events to file"};
 
     for (unsigned int i = 0; i < sizeof(lines) / sizeof(const char*); i++) {
         printf("%s\n", lines[i]);
@@ -331,8 +423,8 @@ static void get_int(int* integer, const toml_table_t* table, const char* name) {
     }
 }
 
-static void get_array(GArray* array, const toml_table_t* table,
-                      const char* name) {
+static void get_search_directories(GArray* array, const toml_table_t* table,
+                                   const char* name) {
     const toml_array_t* toml_array = toml_array_in(table, name);
 
     if (toml_array) {
@@ -340,8 +432,8 @@ static void get_array(GArray* array, const toml_table_t* table,
             toml_datum_t value = toml_string_at(toml_array, i);
 
             if (value.ok) {
-                char* copy = mem_strdup(MemoryNamespaceOpt, value.u.s);
-                g_array_append_val(array, copy);
+                add_search_directory(array, value.u.s);
+                free(value.u.s);
             }
         }
     }
@@ -423,6 +515,30 @@ static int parse_target(const ProjectConfig* config,
              "gsc_fatal_warnings");
 
     get_int(&target_config->optimization_level, target_table, "opt");
+    get_str(&target_config->opt_pipeline, target_table, "opt_pipeline");
+    get_bool(&target_config->separate_compilation, target_table,
+             "separate_compilation");
+    get_int(&target_config->codegen_shards, target_table, "codegen_shards");
+    if (target_config->codegen_shards < 1) {
+        print_message(Error,
+                      "Invalid project configuration, codegen_shards must be "
+                      "at least 1: %d",
+                      target_config->codegen_shards);
+        return PROJECT_SEMANTIC_ERR;
+    }
+    get_bool(&target_config->keep_intermediates, target_table,
+             "keep_intermediates");
+    get_bool(&target_config->emit_interfaces, target_table, "emit_interfaces");
+
+    char* lto = NULL;
+    get_str(&lto, target_table, "lto");
+    if (lto != NULL
+        && get_lto_mode_from_str(&target_config->lto, lto) != PROJECT_OK) {
+        print_message(Error,
+                      "Invalid project configuration, lto is invalid: %s",
+                      lto);
+        return PROJECT_SEMANTIC_ERR;
+    }
 
     char* mode = NULL;
     get_str(&mode, target_table, "mode");
@@ -430,15 +546,17 @@ static int parse_target(const ProjectConfig* config,
     if (err != PROJECT_OK) {
         return err;
     }
-    char* cwd        = g_get_current_dir();
-    char* cached_cwd = mem_strdup(MemoryNamespaceOpt, cwd);
-    free(cwd);
+    char* cwd = g_get_current_dir();
 
-    g_array_append_val(target_config->link_search_paths, cached_cwd);
-    get_array(target_config->link_search_paths, target_table, "link-paths");
+    add_search_directory(target_config->link_search_paths, cwd);
+    get_search_directories(target_config->link_search_paths, target_table,
+                           "link-paths");
 
-    g_array_append_val(target_config->import_paths, cached_cwd);
-    get_array(target_config->import_paths, target_table, "import-paths");
+    add_search_directory(target_config->import_paths, cwd);
+    get_search_directories(target_config->import_paths, target_table,
+                           "import-paths");
+
+    g_free(cwd);
 
     g_hash_table_insert(config->targets, target_config->name, target_config);
 
@@ -522,6 +640,9 @@ void delete_target_config(TargetConfig* config) {
     if (config->output_directory != NULL) {
         mem_free(config->output_directory);
     }
+    if (config->opt_pipeline != NULL) {
+        mem_free(config->opt_pipeline);
+    }
     if (config->link_search_paths) {
         for (guint i = 0; i < config->link_search_paths->len; i++) {
             mem_free(g_array_index(config->link_search_paths, char*, i));
@@ -16,6 +16,15 @@
 
 #define TOML_ERROR_MSG_BUF 256
 
+typedef enum TargetLTOMode_t {
+    // link native object files
+    LTOModeNone,
+    // emit bitcode and optimize per module at link time
+    LTOModeThin,
+    // emit bitcode and optimize all modules merged at link time
+    LTOModeFull
+} TargetLTOMode;
+
 typedef struct TargetLinkConfig_t {
     // name of object files to link
     GArray* object_file_names;
@@ -25,6 +34,12 @@ typedef struct TargetLinkConfig_t {
     bool colorize;
     char* output_file;
     char* driver;
+    // link time optimization of bitcode object files
+    TargetLTOMode lto;
+    // number between 1 and 3
+    int optimization_level;
+    // file descriptors of object files passed from memory
+    GArray* memory_objects;
 } TargetLinkConfig;
 
 typedef enum TargetCompilationMode_t {
@@ -58,6 +73,21 @@ typedef struct TargetConfig_t {
     TargetCompilationMode mode;
     // number between 1 and 3
     int optimization_level;
+    // custom LLVM pass pipeline (e.g. "default<Oz>")
+    // if this is NULL the pipeline is derived from optimization_level
+    char* opt_pipeline;
+    // compile every module file into its own object file
+    bool separate_compilation;
+    // number of shards the functions are split into, each of them is
+    // compiled on its own thread into its own object file
+    int codegen_shards;
+    // emit bitcode instead of native objects for link time optimization
+    TargetLTOMode lto;
+    // write object files to the archive directory even if the binary
+    // driver is able to link them from memory
+    bool keep_intermediates;
+    // write module interface files next to the parsed module files
+    bool emit_interfaces;
     // path to look for object files
     // (can be extra library paths, auto included is output_directory)
     GArray* link_search_paths;
@@ -154,6 +184,7 @@ void delete_target_config(TargetConfig*);
 /**
  * @brief Parse the given command line arguments so that calls to
  *        is_option_set() and get_option() can be made safely.
+ *        Options of a previous call are replaced.
  * @param argc Number of arguments
  * @param argv Array of arguments
  */
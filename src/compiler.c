@@ -8,24 +8,24 @@
 #include <codegen/backend.h>
 #include <compiler.h>
 #include <io/files.h>
+#include <io/interface.h>
+#include <io/manifest.h>
 #include <lex/util.h>
 #include <llvm/backend.h>
 #include <mem/cache.h>
 #include <set/set.h>
 #include <stdlib.h>
 #include <sys/log.h>
+#include <sys/prof.h>
 #include <yacc/parser.tab.h>
 
-#define GRAPHVIZ_FILE_EXTENSION "gv"
-
-extern void yyrestart(FILE*);
+#ifdef __unix__
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
-// Module AST node used by the parser for AST construction.
-[[maybe_unused]] AST_NODE_PTR root;
-// Current file which gets compiled the parser.
-// NOTE: due to global state no concurrent compilation is possible
-//       on parser level.
-[[maybe_unused]] ModuleFile* current_file;
+#define GRAPHVIZ_FILE_EXTENSION "gv"
 
 /**
  * @brief Compile the specified file into AST
@@ -44,25 +44,31 @@ static int compile_file_to_ast(AST_NODE_PTR ast, ModuleFile* file) {
 
     if (file->handle == NULL) {
         INFO("unable to open file: %s", file->path);
-        print_message(Error, "Cannot open file %s: %s", file->path,
-                      strerror(errno));
+        print_file_message(file, Error, "Cannot open file %s: %s",
+                           file->path, strerror(errno));
         return EXIT_FAILURE;
     }
 
-    DEBUG("parsing file: %s", file->path);
-    // setup global state
-    root         = ast;
-    current_file = file;
-    yyin         = file->handle;
-    yyrestart(yyin);
-    lex_reset();
+    ProfilePhase phase = prof_begin("parse", file->path);
+
+    ParseContext context;
+    lex_init_context(&context, ast, file);
+
+    // the source is read once, its digest decides whether the interface
+    // is up to date and is recorded in the build manifest
+    int status = EXIT_SUCCESS;
+    if (lex_load_source(&context) != 0) {
+        print_file_message(file, Error, "Cannot read file %s", file->path);
+        status = EXIT_FAILURE;
+    } else if (!interface_load(ast, file)) {
+        DEBUG("parsing file: %s", file->path);
+
+        status = lex_parse_file(&context);
+    }
 
-    int status = yyparse();
+    lex_release_source(&context);
 
-    // clean up global state
-    // current_file = NULL;
-    root = NULL;
-    yyin = NULL;
+    prof_end(&phase);
 
     return status;
 }
@@ -152,17 +158,8 @@ static void print_ast_to_file(AST_NODE_PTR ast, const TargetConfig* target) {
 
 static int run_backend_codegen(const Module* module,
                                const TargetConfig* target) {
-    DEBUG("initializing LLVM codegen backend...");
-    llvm_backend_init();
-
-    DEBUG("initiializing backend for codegen...");
-    BackendError err = init_backend();
-    if (err.kind != Success) {
-        return EXIT_FAILURE;
-    }
-
     DEBUG("generating code...");
-    err = generate_code(module, target);
+    BackendError err = generate_code(module, target);
     if (err.kind != Success) {
         print_message(Error, "Backend failed: %s", err.impl.message);
         return EXIT_FAILURE;
@@ -170,51 +167,437 @@ static int run_backend_codegen(const Module* module,
 
     print_message(Info, "Compilation finished successfully");
 
-    err = deinit_backend();
-    if (err.kind != Success) {
-        ERROR("Unable to deinit backend: %s", err.impl.message);
-        return EXIT_FAILURE;
-    }
-
     return EXIT_SUCCESS;
 }
 
-const char* get_absolute_import_path(const TargetConfig* config,
-                                     const char* import_target_name) {
+/**
+ * @brief Resolve the path of an import and record it on the importing file.
+ * @param config target the import is resolved for
+ * @param file importing module file
+ * @param import_target_name name of the imported module
+ * @return canonical path of the imported file or NULL if it was not found
+ */
+static const char* get_absolute_import_path(const TargetConfig* config,
+                                            ModuleFile* file,
+                                            const char* import_target_name) {
     INFO("resolving absolute path for import target: %s", import_target_name);
 
-    if (!g_str_has_suffix(import_target_name, ".gsc")) {
-        char* full_filename = g_strjoin("", import_target_name, ".gsc", NULL);
-        import_target_name  = mem_strdup(MemoryNamespaceLld, full_filename);
-        g_free(full_filename);
+    char* full_filename = g_str_has_suffix(import_target_name, ".gsc")
+                            ? g_strdup(import_target_name)
+                            : g_strjoin("", import_target_name, ".gsc", NULL);
+
+    const char* path =
+      find_file_in_directories(config->import_paths, full_filename);
+
+    if (path != NULL) {
+        INFO("import target found at: %s", path);
+        add_file_import(file, full_filename, path);
+    }
+
+    g_free(full_filename);
+
+    return path;
+}
+
+/**
+ * @brief Module file parsed ahead of any build.
+ */
+typedef struct PreloadedModule_t {
+    ModuleFile* file;
+    AST_NODE_PTR module;
+} PreloadedModule;
+
+// maps canonical paths to preloaded modules
+// NULL if no modules were preloaded
+static GHashTable* preloaded_modules = NULL;
+
+// files of preloaded modules, owned until a build takes the module
+static ModuleFileStack preloaded_files;
+
+/**
+ * @brief Import of a module which is to be parsed.
+ */
+typedef struct ParseJob_t {
+    // index of the module in the module graph
+    guint index;
+    ModuleFile* file;
+    AST_NODE_PTR module;
+    int status;
+    // module was taken from the preloaded modules and needs no parsing
+    bool preloaded;
+} ParseJob;
+
+static void run_parse_job(gpointer data, [[maybe_unused]] gpointer user_data) {
+    ParseJob* job = data;
+
+    if (job->preloaded) {
+        return;
     }
 
-    for (guint i = 0; i < config->import_paths->len; i++) {
-        const char* import_directory_path =
-          g_array_index(config->import_paths, char*, i);
+    job->status = compile_file_to_ast(job->module, job->file);
+}
+
+static void preload_module(const char* path) {
+    ModuleFile* file    = push_file(&preloaded_files, path);
+    AST_NODE_PTR module = AST_new_node(empty_location(file), AST_Module, NULL);
+
+    const int status = compile_file_to_ast(module, file);
 
-        char* path =
-          g_build_filename(import_directory_path, import_target_name, NULL);
-        char* cwd       = g_get_current_dir();
-        char* canonical = g_canonicalize_filename(path, cwd);
+    // keep no descriptor open for the lifetime of the server, the file is
+    // opened again once a build takes the module
+    if (file->handle != NULL) {
+        fclose(file->handle);
+        file->handle = NULL;
+    }
 
-        const gboolean exists = g_file_test(canonical, G_FILE_TEST_EXISTS);
-        const gboolean is_dir = g_file_test(canonical, G_FILE_TEST_IS_DIR);
+    // diagnostics of preloaded modules would never reach the client
+    if (status != EXIT_SUCCESS || file->statistics.info_count > 0
+        || file->statistics.warning_count > 0
+        || file->statistics.error_count > 0) {
+        INFO("not preloading module: %s", path);
+        AST_delete_node(module);
+        return;
+    }
 
-        char* cached_canonical = mem_strdup(MemoryNamespaceLld, canonical);
+    PreloadedModule* preloaded =
+      mem_alloc(MemoryNamespaceStatic, sizeof(PreloadedModule));
+    preloaded->file   = file;
+    preloaded->module = module;
+
+    g_hash_table_insert(preloaded_modules, (gpointer) path, preloaded);
+    INFO("preloaded module: %s", path);
+}
+
+static void preload_directory(const char* directory) {
+    GDir* dir = g_dir_open(directory, 0, NULL);
+    if (dir == NULL) {
+        print_message(Warning, "Unable to preload modules from: %s",
+                      directory);
+        return;
+    }
+
+    const gchar* name = NULL;
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        char* path = g_build_filename(directory, name, NULL);
+
+        // symbolic links to directories are skipped to avoid cycles
+        if (g_file_test(path, G_FILE_TEST_IS_DIR)) {
+            if (!g_file_test(path, G_FILE_TEST_IS_SYMLINK)) {
+                preload_directory(path);
+            }
+        } else if (g_str_has_suffix(name, ".gsc")
+                   && !g_hash_table_contains(preloaded_modules, path)) {
+            preload_module(mem_strdup(MemoryNamespaceStatic, path));
+        }
 
         g_free(path);
-        g_free(cwd);
-        g_free(canonical);
+    }
+
+    g_dir_close(dir);
+}
+
+void preload_modules(const GArray* directories) {
+    if (preloaded_modules == NULL) {
+        preloaded_modules = g_hash_table_new(g_str_hash, g_str_equal);
+        preloaded_files   = new_file_stack();
+    }
+
+    char* cwd = g_get_current_dir();
+
+    for (guint i = 0; i < directories->len; i++) {
+        char* directory = g_canonicalize_filename(
+          g_array_index(directories, const char*, i), cwd);
+
+        preload_directory(directory);
+
+        g_free(directory);
+    }
+
+    g_free(cwd);
+
+    print_message(Info, "Preloaded %u modules",
+                  g_hash_table_size(preloaded_modules));
+}
+
+/**
+ * @brief Take the preloaded module of the given file if its content did not
+ *        change since it was parsed. A module can only be taken once as it
+ *        is merged into the module importing it.
+ * @param unit file stack to add the file of the module to
+ * @param path canonical path of the module file
+ * @param job job to complete with the preloaded module
+ * @return true if the module was preloaded
+ */
+static bool take_preloaded_module(ModuleFileStack* unit, const char* path,
+                                  ParseJob* job) {
+    if (preloaded_modules == NULL) {
+        return false;
+    }
+
+    PreloadedModule* preloaded = g_hash_table_lookup(preloaded_modules, path);
+    if (preloaded == NULL) {
+        return false;
+    }
+    g_hash_table_remove(preloaded_modules, path);
+
+    // the digest of the file is the one of the source it was parsed from
+    char* digest         = manifest_file_digest(path);
+    const bool unchanged =
+      digest != NULL && strcmp(digest, preloaded->file->digest) == 0;
+    g_free(digest);
+
+    FILE* handle = unchanged ? fopen(path, "r") : NULL;
+
+    if (handle == NULL) {
+        INFO("preloaded module changed: %s", path);
+        return false;
+    }
+
+    // diagnostics of later phases read the source through the handle
+    preloaded->file->handle = handle;
+
+    g_array_append_val(unit->files, preloaded->file);
+
+    job->file      = preloaded->file;
+    job->module    = preloaded->module;
+    job->status    = EXIT_SUCCESS;
+    job->preloaded = true;
+
+    return true;
+}
+
+/**
+ * @brief Drop all preloaded modules. Required once the memory of syntax
+ *        trees is purged.
+ */
+static void drop_preloaded_modules(void) {
+    if (preloaded_modules != NULL) {
+        g_hash_table_remove_all(preloaded_modules);
+    }
+}
+
+/**
+ * @brief Parse all jobs. In case there is more than a single job they are
+ *        parsed concurrently on a thread pool.
+ * @param jobs
+ */
+static void run_parse_jobs(GArray* jobs) {
+    if (jobs->len == 1) {
+        run_parse_job(&g_array_index(jobs, ParseJob, 0), NULL);
+        return;
+    }
+
+    GThreadPool* pool = g_thread_pool_new(
+      run_parse_job, NULL, (gint) g_get_num_processors(), FALSE, NULL);
+
+    for (guint i = 0; i < jobs->len; i++) {
+        ParseJob* job = &g_array_index(jobs, ParseJob, i);
+
+        buffer_diagnostics(job->file);
+        g_thread_pool_push(pool, job, NULL);
+    }
+
+    // wait for all files to be parsed
+    g_thread_pool_free(pool, FALSE, TRUE);
+
+    // print diagnostics in order of the imports regardless of which
+    // file was parsed first
+    for (guint i = 0; i < jobs->len; i++) {
+        flush_diagnostics(g_array_index(jobs, ParseJob, i).file);
+    }
+}
+
+/**
+ * @brief State of a module during the traversal of the module graph.
+ */
+typedef enum ModuleVisit_t {
+    ModuleUnvisited,
+    ModuleVisiting,
+    ModuleVisited
+} ModuleVisit;
+
+/**
+ * @brief Module file within the import graph of a compilation unit.
+ */
+typedef struct ModuleNode_t {
+    ModuleFile* file;
+    AST_NODE_PTR module;
+    // indices of the imported modules in the graph
+    GArray* imports;
+    ModuleVisit visit;
+} ModuleNode;
+
+/**
+ * @brief Graph of all module files of a compilation unit. Every file is
+ *        contained exactly once regardless of the path it is imported by.
+ */
+typedef struct ModuleGraph_t {
+    // maps module identities to the index of their node
+    GHashTable* ids;
+    GArray* nodes;
+} ModuleGraph;
+
+/**
+ * @brief Get the identity of a module file. Files are identified by
+ *        device and inode so that hard and symbolic links to the same
+ *        file are considered the same module.
+ * @param path
+ * @return identity of the file
+ */
+static const char* get_module_id(const char* path) {
+#ifdef __unix__
+    struct stat file_stat;
+    if (stat(path, &file_stat) == 0) {
+        char* id = g_strdup_printf("%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT,
+                                   (guint64) file_stat.st_dev,
+                                   (guint64) file_stat.st_ino);
+        char* cached_id = mem_strdup(MemoryNamespaceAst, id);
+        g_free(id);
+        return cached_id;
+    }
+#endif
+
+    return path;
+}
+
+static ModuleNode* get_module_node(const ModuleGraph* graph, guint index) {
+    return &g_array_index(graph->nodes, ModuleNode, index);
+}
+
+static guint add_module_node(ModuleGraph* graph, const char* id,
+                             ModuleFile* file, AST_NODE_PTR module) {
+    ModuleNode node;
+    node.file    = file;
+    node.module  = module;
+    node.imports = mem_new_g_array(MemoryNamespaceAst, sizeof(guint));
+    node.visit   = ModuleUnvisited;
+
+    const guint index = graph->nodes->len;
+    g_array_append_val(graph->nodes, node);
+    g_hash_table_insert(graph->ids, (gpointer) id, GUINT_TO_POINTER(index));
+
+    return index;
+}
+
+static void print_import_cycle(const ModuleGraph* graph, const GArray* stack,
+                               guint index) {
+    GString* cycle = g_string_new(NULL);
+
+    // the cycle starts at the first occurrence of the module on the stack
+    guint start = 0;
+    while (g_array_index(stack, guint, start) != index) {
+        start++;
+    }
+
+    for (guint i = start; i < stack->len; i++) {
+        const guint node = g_array_index(stack, guint, i);
+        g_string_append(cycle, get_module_node(graph, node)->file->path);
+        g_string_append(cycle, " -> ");
+    }
+    g_string_append(cycle, get_module_node(graph, index)->file->path);
+
+    print_message(Warning, "Import cycle: %s", cycle->str);
+
+    g_string_free(cycle, TRUE);
+}
+
+/**
+ * @brief Sort the module graph so that every module comes after all
+ *        modules it imports. Import cycles are reported and broken up.
+ * @param graph
+ * @param index module to start from
+ * @param stack modules currently visited
+ * @param order output list of module indices
+ */
+static void sort_module_graph(ModuleGraph* graph, guint index, GArray* stack,
+                              GArray* order) {
+    ModuleNode* node = get_module_node(graph, index);
+
+    node->visit = ModuleVisiting;
+    g_array_append_val(stack, index);
+
+    for (guint i = 0; i < node->imports->len; i++) {
+        const guint import = g_array_index(node->imports, guint, i);
+
+        switch (get_module_node(graph, import)->visit) {
+            case ModuleUnvisited:
+                sort_module_graph(graph, import, stack, order);
+                break;
+            case ModuleVisiting:
+                print_import_cycle(graph, stack, import);
+                break;
+            case ModuleVisited:
+                break;
+        }
+    }
+
+    g_array_set_size(stack, stack->len - 1);
+    node->visit = ModuleVisited;
+    g_array_append_val(order, index);
+}
+
+/**
+ * @brief Collect the imports of a module. Imports of files already in the
+ *        graph only add an edge, new files are queued for parsing.
+ * @param unit
+ * @param target
+ * @param graph
+ * @param index module to collect the imports of
+ * @param jobs list of new modules to parse
+ * @return EXIT_SUCCESS if all imports could be resolved
+ */
+static int collect_module_imports(ModuleFileStack* unit,
+                                  const TargetConfig* target,
+                                  ModuleGraph* graph, guint index,
+                                  GArray* jobs) {
+    const AST_NODE_PTR module = get_module_node(graph, index)->module;
+    ModuleFile* file          = get_module_node(graph, index)->file;
+
+    for (size_t i = 0; i < AST_get_child_count(module); i++) {
+        AST_NODE_PTR child = AST_get_node(module, i);
+
+        if (child->kind != AST_Import && child->kind != AST_Include) {
+            continue;
+        }
+
+        const char* path =
+          get_absolute_import_path(target, file, child->value);
+        if (path == NULL) {
+            print_message(Error, "Cannot resolve path for import: `%s`",
+                          child->value);
+            return EXIT_FAILURE;
+        }
+
+        const char* id  = get_module_id(path);
+        gpointer import = NULL;
+
+        if (!g_hash_table_lookup_extended(graph->ids, id, NULL, &import)) {
+            ParseJob job;
+            job.preloaded = false;
 
-        if (exists && !is_dir) {
-            INFO("import target found at: %s", cached_canonical);
-            return cached_canonical;
+            if (!take_preloaded_module(unit, path, &job)) {
+                job.file   = push_file(unit, path);
+                job.module = AST_new_node(empty_location(job.file),
+                                          AST_Module, NULL);
+                job.status = EXIT_FAILURE;
+            }
+
+            job.index = add_module_node(graph, id, job.file, job.module);
+            import    = GUINT_TO_POINTER(job.index);
+            g_array_append_val(jobs, job);
+
+            gchar* directory = g_path_get_dirname(path);
+            add_search_directory(target->import_paths, directory);
+            g_free(directory);
         }
+
+        // nodes may have moved when new modules were added
+        const guint import_index = GPOINTER_TO_UINT(import);
+        g_array_append_val(get_module_node(graph, index)->imports,
+                           import_index);
     }
 
-    // file not found
-    return NULL;
+    return EXIT_SUCCESS;
 }
 
 static int compile_module_with_dependencies(ModuleFileStack* unit,
@@ -222,52 +605,79 @@ static int compile_module_with_dependencies(ModuleFileStack* unit,
                                             const TargetConfig* target,
                                             AST_NODE_PTR root_module) {
 
-    GHashTable* imports =
+    if (compile_file_to_ast(root_module, file) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    if (target->emit_interfaces) {
+        interface_write(root_module, file);
+    }
+
+    ModuleGraph graph;
+    graph.nodes = mem_new_g_array(MemoryNamespaceAst, sizeof(ModuleNode));
+    graph.ids =
       mem_new_g_hash_table(MemoryNamespaceAst, g_str_hash, g_str_equal);
 
-    if (compile_file_to_ast(root_module, file) == EXIT_SUCCESS) {
+    add_module_node(&graph, get_module_id(file->path), file, root_module);
 
-        for (size_t i = 0; i < AST_get_child_count(root_module); i++) {
-            AST_NODE_PTR child = AST_get_node(root_module, i);
+    GArray* jobs = mem_new_g_array(MemoryNamespaceAst, sizeof(ParseJob));
 
-            if (child->kind == AST_Import || child->kind == AST_Include) {
+    // the graph is built in batches: all new files imported by the
+    // previous batch are parsed concurrently, then their imports are
+    // collected in turn
+    guint start = 0;
+    do {
+        const guint end = graph.nodes->len;
 
-                const char* path =
-                  get_absolute_import_path(target, child->value);
-                if (path == NULL) {
-                    print_message(Error, "Cannot resolve path for import: `%s`",
-                                  child->value);
-                    return EXIT_FAILURE;
-                }
+        g_array_set_size(jobs, 0);
+        for (guint i = start; i < end; i++) {
+            if (collect_module_imports(unit, target, &graph, i, jobs)
+                != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
 
-                if (g_hash_table_contains(imports, path)) {
-                    continue;
-                }
+        if (jobs->len == 0) {
+            break;
+        }
 
-                ModuleFile* imported_file = push_file(unit, path);
-                AST_NODE_PTR imported_module =
-                  AST_new_node(empty_location(imported_file), AST_Module, NULL);
+        run_parse_jobs(jobs);
 
-                if (compile_file_to_ast(imported_module, imported_file)
-                    == EXIT_SUCCESS) {
-                    AST_merge_modules(root_module, i + 1, imported_module);
-                } else {
-                    return EXIT_FAILURE;
-                }
+        for (guint i = 0; i < jobs->len; i++) {
+            const ParseJob* job = &g_array_index(jobs, ParseJob, i);
 
-                g_hash_table_insert(imports, (gpointer) path, NULL);
+            if (job->status != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
 
-                gchar* directory = g_path_get_dirname(path);
-                gchar* cached_directory =
-                  mem_strdup(MemoryNamespaceLld, directory);
-                g_free(directory);
-                g_array_append_val(target->import_paths, cached_directory);
+            if (target->emit_interfaces) {
+                interface_write(job->module, job->file);
             }
         }
-    } else {
-        return EXIT_FAILURE;
+
+        start = end;
+    } while (TRUE);
+
+    ProfilePhase phase = prof_begin("merge", file->path);
+
+    GArray* stack = mem_new_g_array(MemoryNamespaceAst, sizeof(guint));
+    GArray* order = mem_new_g_array(MemoryNamespaceAst, sizeof(guint));
+    sort_module_graph(&graph, 0, stack, order);
+
+    // merge imported modules in front of the root module so that every
+    // module follows the modules it depends on, the root comes last
+    size_t offset = 0;
+    for (guint i = 0; i < order->len - 1; i++) {
+        const guint index = g_array_index(order, guint, i);
+        AST_NODE_PTR module = get_module_node(&graph, index)->module;
+
+        const size_t count = AST_get_child_count(module);
+        AST_merge_modules(root_module, offset, module);
+        offset += count;
     }
 
+    prof_end(&phase);
+
     return EXIT_SUCCESS;
 }
 
@@ -281,7 +691,22 @@ static int build_target(ModuleFileStack* unit, const TargetConfig* target) {
 
     print_message(Info, "Building target: %s", target->name);
 
-    ModuleFile* file = push_file(unit, target->root_module);
+    const bool use_cache = !is_option_set("no-cache");
+    char* config_digest  = manifest_config_digest(target);
+
+    if (use_cache && manifest_is_up_to_date(target, config_digest)) {
+        print_message(Info, "Target is up to date: %s", target->name);
+        g_free(config_digest);
+        return EXIT_SUCCESS;
+    }
+
+    ProfilePhase phase = prof_begin("build", target->name);
+
+    // a failed build must never be considered up to date
+    manifest_discard(target);
+
+    const guint first_file = unit->files == NULL ? 0 : unit->files->len;
+    ModuleFile* file       = push_file(unit, target->root_module);
     AST_NODE_PTR root_module =
       AST_new_node(empty_location(file), AST_Module, NULL);
 
@@ -292,7 +717,10 @@ static int build_target(ModuleFileStack* unit, const TargetConfig* target) {
             if (err == 0) {
 
                 print_ast_to_file(root_module, target);
-                Module* module = create_set(root_module);
+
+                ProfilePhase semantic = prof_begin("semantic", target->name);
+                Module* module        = create_set(root_module);
+                prof_end(&semantic);
 
                 if (module != NULL) {
                     err = run_backend_codegen(module, target);
@@ -308,6 +736,16 @@ static int build_target(ModuleFileStack* unit, const TargetConfig* target) {
     mem_purge_namespace(MemoryNamespaceLex);
     mem_purge_namespace(MemoryNamespaceAst);
     mem_purge_namespace(MemoryNamespaceSet);
+    drop_preloaded_modules();
+
+    if (err == EXIT_SUCCESS && use_cache) {
+        // the artifacts are valid regardless of whether the manifest
+        // could be written
+        (void) manifest_write(target, config_digest, unit, first_file);
+    }
+    g_free(config_digest);
+
+    prof_end(&phase);
 
     print_file_statistics(file);
 
@@ -337,6 +775,268 @@ static int compile_file(ModuleFileStack* unit) {
     return err;
 }
 
+/**
+ * @brief Get the maximum number of targets to build concurrently as specified
+ *        by --jobs=N. Without a value the number of available processors is
+ *        used.
+ * @return number of jobs, at least 1
+ */
+static guint get_job_count(void) {
+    if (!is_option_set("jobs")) {
+        return 1;
+    }
+
+    const Option* opt = get_option("jobs");
+    if (opt->value == NULL) {
+        return g_get_num_processors();
+    }
+
+    char* end  = NULL;
+    long count = strtol(opt->value, &end, 10);
+    if (*end != 0 || count < 1) {
+        print_message(Warning, "Invalid number of jobs: %s", opt->value);
+        return 1;
+    }
+
+    return (guint) count;
+}
+
+#ifdef __unix__
+
+/**
+ * @brief A single target built by a separate worker process.
+ *        Each worker owns its own copy of the parser, SET and LLVM state.
+ */
+typedef struct BuildJob_t {
+    const TargetConfig* target;
+    // captured stdout and stderr of the worker
+    FILE* output;
+    // diagnostic statistics of every file compiled by the worker
+    FILE* statistics;
+    // phases recorded by the worker, NULL if profiling is disabled
+    FILE* profile;
+    pid_t pid;
+    int status;
+} BuildJob;
+
+/**
+ * @brief Entry point of a worker process. Never returns.
+ * @param job
+ */
+[[noreturn]]
+static void run_build_job(BuildJob* job) {
+    dup2(fileno(job->output), STDOUT_FILENO);
+    dup2(fileno(job->output), STDERR_FILENO);
+
+    ModuleFileStack files = new_file_stack();
+    int status            = build_target(&files, job->target);
+
+    if (files.files != NULL) {
+        for (guint i = 0; i < files.files->len; i++) {
+            const ModuleFile* file =
+              g_array_index(files.files, ModuleFile*, i);
+
+            fprintf(job->statistics, "%lu %lu %lu\t%s\n",
+                    file->statistics.info_count,
+                    file->statistics.warning_count,
+                    file->statistics.error_count, file->path);
+        }
+    }
+
+    fflush(job->statistics);
+    if (job->profile != NULL) {
+        prof_write_records(job->profile);
+    }
+    fflush(stdout);
+    fflush(stderr);
+
+    exit(status);
+}
+
+/**
+ * @brief Replay the output of a finished job and merge the diagnostic
+ *        statistics of its files into the unit.
+ * @param unit
+ * @param job
+ */
+static void collect_build_job(ModuleFileStack* unit, BuildJob* job) {
+    char buffer[BUFSIZ];
+    size_t bytes;
+
+    rewind(job->output);
+    while ((bytes = fread(buffer, 1, sizeof(buffer), job->output)) > 0) {
+        fwrite(buffer, 1, bytes, stdout);
+    }
+    fflush(stdout);
+
+    char* line  = NULL;
+    size_t size = 0;
+
+    rewind(job->statistics);
+    while (getline(&line, &size, job->statistics) > 0) {
+        FileDiagnosticStatistics statistics;
+        int offset = 0;
+
+        if (sscanf(line, "%lu %lu %lu\t%n", &statistics.info_count,
+                   &statistics.warning_count, &statistics.error_count,
+                   &offset)
+              != 3
+            || offset == 0) {
+            continue;
+        }
+
+        line[strcspn(line, "\n")] = 0;
+
+        ModuleFile* file =
+          push_file(unit, mem_strdup(MemoryNamespaceStatic, line + offset));
+        file->statistics = statistics;
+    }
+    free(line);
+
+    if (job->profile != NULL) {
+        prof_read_records(job->profile);
+        fclose(job->profile);
+    }
+
+    fclose(job->output);
+    fclose(job->statistics);
+}
+
+/**
+ * @brief Build multiple targets concurrently with at most the given amount
+ *        of worker processes. Output of each target is buffered and written
+ *        in order of the targets once all workers have finished.
+ * @param unit
+ * @param targets
+ * @param job_count
+ * @return EXIT_SUCCESS if all targets were built successfully
+ */
+static int build_targets_parallel(ModuleFileStack* unit, GArray* targets,
+                                  guint job_count) {
+    INFO("building %d targets with %d jobs", targets->len, job_count);
+
+    BuildJob* jobs =
+      mem_alloc(MemoryNamespaceStatic, sizeof(BuildJob) * targets->len);
+
+    // prevent buffered output from being duplicated into workers
+    fflush(stdout);
+    fflush(stderr);
+
+    guint running  = 0;
+    guint next     = 0;
+    guint finished = 0;
+
+    while (finished < targets->len) {
+        while (next < targets->len && running < job_count) {
+            BuildJob* job   = &jobs[next++];
+            job->target     = g_array_index(targets, TargetConfig*, next - 1);
+            job->output     = tmpfile();
+            job->statistics = tmpfile();
+            job->profile    = prof_is_enabled() ? tmpfile() : NULL;
+            job->status     = EXIT_FAILURE;
+            job->pid        = -1;
+
+            if (job->output == NULL || job->statistics == NULL) {
+                print_message(Error, "Unable to buffer output of target %s: %s",
+                              job->target->name, strerror(errno));
+                finished++;
+                continue;
+            }
+
+            job->pid = fork();
+            if (job->pid == 0) {
+                run_build_job(job);
+            } else if (job->pid < 0) {
+                print_message(Error, "Unable to start job for target %s: %s",
+                              job->target->name, strerror(errno));
+                finished++;
+                continue;
+            }
+
+            running++;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (guint i = 0; i < next; i++) {
+            if (jobs[i].pid == pid) {
+                jobs[i].status =
+                  WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+                running--;
+                finished++;
+                break;
+            }
+        }
+    }
+
+    int err = EXIT_SUCCESS;
+    for (guint i = 0; i < next; i++) {
+        if (jobs[i].output != NULL && jobs[i].statistics != NULL) {
+            collect_build_job(unit, &jobs[i]);
+        } else {
+            if (jobs[i].output != NULL) {
+                fclose(jobs[i].output);
+            }
+            if (jobs[i].statistics != NULL) {
+                fclose(jobs[i].statistics);
+            }
+            if (jobs[i].profile != NULL) {
+                fclose(jobs[i].profile);
+            }
+        }
+
+        if (jobs[i].status != EXIT_SUCCESS) {
+            err = EXIT_FAILURE;
+        }
+    }
+
+    mem_free(jobs);
+
+    return err;
+}
+
+#endif
+
+/**
+ * @brief Build a list of targets. If more than one job is requested
+ *        targets are built in parallel.
+ * @param unit
+ * @param targets
+ * @return EXIT_SUCCESS if all targets were built successfully
+ */
+static int build_targets(ModuleFileStack* unit, GArray* targets) {
+    const guint job_count = get_job_count();
+
+#ifdef __unix__
+    if (job_count > 1 && targets->len > 1) {
+        return build_targets_parallel(unit, targets, job_count);
+    }
+#else
+    if (job_count > 1) {
+        print_message(Warning, "Parallel builds are not supported on this "
+                               "platform, building sequentially");
+    }
+#endif
+
+    int err = EXIT_SUCCESS;
+
+    for (guint i = 0; i < targets->len; i++) {
+        if (build_target(unit, g_array_index(targets, TargetConfig*, i))
+            != EXIT_SUCCESS) {
+            err = EXIT_FAILURE;
+        }
+    }
+
+    return err;
+}
+
 /**
  * @brief Build all project targets specified by the command line arguments.
  * @param unit
@@ -346,6 +1046,9 @@ static int build_project_targets(ModuleFileStack* unit,
                                  const ProjectConfig* config) {
     int err = EXIT_SUCCESS;
 
+    GArray* selected =
+      mem_new_g_array(MemoryNamespaceOpt, sizeof(TargetConfig*));
+
     if (is_option_set("all")) {
         // build all targets in the project
         GHashTableIter iter;
@@ -356,31 +1059,38 @@ static int build_project_targets(ModuleFileStack* unit,
         TargetConfig* val;
         while (
           g_hash_table_iter_next(&iter, (gpointer) &key, (gpointer) &val)) {
-            err = build_target(unit, val);
+            g_array_append_val(selected, val);
         }
-        return err;
-    }
 
-    // build all targets given in the arguments
-    GArray* targets = get_non_options_after("build");
+        err = build_targets(unit, selected);
+    } else {
+        // build all targets given in the arguments
+        GArray* targets = get_non_options_after("build");
+
+        if (targets != NULL) {
+            for (guint i = 0; i < targets->len; i++) {
+                const char* target_name =
+                  g_array_index(targets, const char*, i);
+
+                if (g_hash_table_contains(config->targets, target_name)) {
+                    TargetConfig* target =
+                      g_hash_table_lookup(config->targets, target_name);
+                    g_array_append_val(selected, target);
+                } else {
+                    print_message(Error, "Unknown target: %s", target_name);
+                }
+            }
 
-    if (targets != NULL) {
-        for (guint i = 0; i < targets->len; i++) {
-            const char* target_name = g_array_index(targets, const char*, i);
+            err = build_targets(unit, selected);
 
-            if (g_hash_table_contains(config->targets, target_name)) {
-                err = build_target(
-                  unit, g_hash_table_lookup(config->targets, target_name));
-            } else {
-                print_message(Error, "Unknown target: %s", target_name);
-            }
+            mem_free(targets);
+        } else {
+            print_message(Error, "No targets specified.");
         }
-
-        mem_free(targets);
-    } else {
-        print_message(Error, "No targets specified.");
     }
 
+    mem_free(selected);
+
     return err;
 }
 
@@ -402,6 +1112,21 @@ static int build_project(ModuleFileStack* unit) {
 }
 
 int run_compiler() {
+    // the backend is shared by all targets, so that target initialization
+    // and target machines are paid for once per process
+    DEBUG("initializing LLVM codegen backend...");
+    llvm_backend_init();
+
+    DEBUG("initiializing backend for codegen...");
+    BackendError err = init_backend();
+    if (err.kind != Success) {
+        print_message(Error, "Unable to initialize backend: %s",
+                      err.impl.message);
+        return EXIT_FAILURE;
+    }
+
+    prof_init();
+
     ModuleFileStack files = new_file_stack();
 
     int status = EXIT_SUCCESS;
@@ -422,5 +1147,15 @@ int run_compiler() {
 
     delete_files(&files);
 
+    err = deinit_backend();
+    if (err.kind != Success) {
+        ERROR("Unable to deinit backend: %s", err.impl.message);
+        status = EXIT_FAILURE;
+    }
+
+    if (prof_report() != EXIT_SUCCESS) {
+        status = EXIT_FAILURE;
+    }
+
     return status;
 }
@@ -5,10 +5,23 @@
 #ifndef GEMSTONE_COMPILER_H
 #define GEMSTONE_COMPILER_H
 
+#include <glib.h>
+
 /**
  * @brief Run the gemstone compiler with the provided command arguments.
  * @return status of compilation
  */
 int run_compiler();
 
+/**
+ * @brief Parse all module files below the given directories ahead of time.
+ *        Builds reuse the syntax tree of a preloaded file as long as its
+ *        content is unchanged instead of parsing it again. Only parsing is
+ *        done ahead of time, semantic analysis runs for every build as it
+ *        depends on all modules of the target.
+ *        Each preloaded module can only be used by a single build.
+ * @param directories list of directories to search for module files
+ */
+void preload_modules(const GArray* directories);
+
 #endif // GEMSTONE_COMPILER_H
@@ -7,6 +7,7 @@
 #include <mem/cache.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/col.h>
 #include <sys/log.h>
 
@@ -49,6 +50,9 @@ ModuleFile* push_file(ModuleFileStack* stack, const char* path) {
     ModuleFile* new_file = mem_alloc(MemoryNamespaceStatic, sizeof(ModuleFile));
     new_file->handle     = NULL;
     new_file->path       = path;
+    new_file->diagnostics              = NULL;
+    new_file->digest                   = NULL;
+    new_file->imports                  = NULL;
     new_file->statistics.warning_count = 0;
     new_file->statistics.error_count   = 0;
     new_file->statistics.info_count    = 0;
@@ -67,6 +71,16 @@ void delete_files(ModuleFileStack* stack) {
             fclose(file->handle);
         }
 
+        if (file->diagnostics != NULL) {
+            g_string_free(file->diagnostics, TRUE);
+        }
+
+        if (file->imports != NULL) {
+            g_array_free(file->imports, TRUE);
+        }
+
+        g_free(file->digest);
+
         mem_free((void*) file);
     }
 
@@ -74,6 +88,26 @@ void delete_files(ModuleFileStack* stack) {
     DEBUG("deleted module file stack");
 }
 
+static void clear_module_import(gpointer data) {
+    ModuleImport* import = data;
+
+    g_free(import->name);
+    g_free(import->path);
+}
+
+void add_file_import(ModuleFile* file, const char* name, const char* path) {
+    if (file->imports == NULL) {
+        file->imports = g_array_new(FALSE, FALSE, sizeof(ModuleImport));
+        g_array_set_clear_func(file->imports, clear_module_import);
+    }
+
+    ModuleImport import;
+    import.name = g_strdup(name);
+    import.path = g_strdup(path);
+
+    g_array_append_val(file->imports, import);
+}
+
 // Number of bytes to read at once whilest
 // seeking the current line in print_diagnostic()
 #define SEEK_BUF_BYTES 256
@@ -93,6 +127,23 @@ static void custom_fgets(char* buffer, size_t n, FILE* stream) {
     }
 }
 
+/**
+ * @brief Print the output of a diagnostic or buffer it if the diagnostics
+ *        of its file are buffered.
+ * @param file file the output belongs to, may be NULL
+ * @param output
+ */
+static void emit_diagnostic_output(ModuleFile* file, GString* output) {
+    if (file != NULL && file->diagnostics != NULL) {
+        g_string_append_len(file->diagnostics, output->str,
+                            (gssize) output->len);
+    } else {
+        fwrite(output->str, 1, output->len, stdout);
+    }
+
+    g_string_free(output, TRUE);
+}
+
 void print_diagnostic(TokenLocation* location, Message kind,
                       const char* message, ...) {
     assert(location->file != NULL);
@@ -134,17 +185,22 @@ void print_diagnostic(TokenLocation* location, Message kind,
 
     const char* absolute_path = get_absolute_path(location->file->path);
 
-    printf("%s%s:%ld:%s %s%s:%s ", BOLD, absolute_path, location->line_start,
-           RESET, accent_color, kind_text, RESET);
+    // the whole diagnostic is written at once so that diagnostics of
+    // files parsed concurrently do not interleave
+    GString* output = g_string_new(NULL);
+
+    g_string_append_printf(output, "%s%s:%u:%s %s%s:%s ", BOLD,
+                           absolute_path, location->line_start, RESET,
+                           accent_color, kind_text, RESET);
 
     va_list args;
     va_start(args, message);
 
-    vprintf(message, args);
+    g_string_append_vprintf(output, message, args);
 
     va_end(args);
 
-    printf("\n");
+    g_string_append(output, "\n");
 
     mem_free((void*) absolute_path);
 
@@ -152,7 +208,7 @@ void print_diagnostic(TokenLocation* location, Message kind,
       location->line_end - location->line_start + 1;
 
     for (unsigned long int l = 0; l < lines; l++) {
-        printf(" %4ld | ", location->line_start + l);
+        g_string_append_printf(output, " %4lu | ", location->line_start + l);
 
         unsigned long int chars = 0;
 
@@ -160,7 +216,8 @@ void print_diagnostic(TokenLocation* location, Message kind,
         unsigned long int limit = min(location->col_start, SEEK_BUF_BYTES);
         while (limit > 1) {
             custom_fgets(buffer, (int) limit, location->file->handle);
-            chars += printf("%s", buffer);
+            g_string_append(output, buffer);
+            chars += strlen(buffer);
             limit = min(location->col_start - chars, SEEK_BUF_BYTES);
 
             if (strchr(buffer, '\n') != NULL) {
@@ -168,14 +225,15 @@ void print_diagnostic(TokenLocation* location, Message kind,
             }
         }
 
-        printf("%s", accent_color);
+        g_string_append(output, accent_color);
 
         chars = 0;
         limit =
           min(location->col_end - location->col_start + 1, SEEK_BUF_BYTES);
         while (limit > 0) {
             custom_fgets(buffer, (int) limit, location->file->handle);
-            chars += printf("%s", buffer);
+            g_string_append(output, buffer);
+            chars += strlen(buffer);
             limit = min(location->col_end - location->col_start + 1 - chars,
                         SEEK_BUF_BYTES);
 
@@ -184,37 +242,56 @@ void print_diagnostic(TokenLocation* location, Message kind,
             }
         }
 
-        printf("%s", RESET);
+        g_string_append(output, RESET);
 
         // print rest of the line
         do {
             custom_fgets(buffer, SEEK_BUF_BYTES, location->file->handle);
-            printf("%s", buffer);
+            g_string_append(output, buffer);
         } while (strchr(buffer, '\n') == NULL);
 
     cont:
-        printf("%s", RESET);
+        g_string_append(output, RESET);
     }
 
-    printf("      | ");
+    g_string_append(output, "      | ");
     for (unsigned long int i = 1; i < location->col_start; i++) {
-        printf(" ");
+        g_string_append_c(output, ' ');
     }
 
-    printf("%s", accent_color);
-    printf("^");
+    g_string_append(output, accent_color);
+    g_string_append_c(output, '^');
     for (unsigned long int i = 0; i < location->col_end - location->col_start;
          i++) {
-        printf("~");
+        g_string_append_c(output, '~');
     }
 
-    printf("%s\n\n", RESET);
+    g_string_append_printf(output, "%s\n\n", RESET);
+
+    emit_diagnostic_output(location->file, output);
+}
+
+void buffer_diagnostics(ModuleFile* file) {
+    if (file->diagnostics == NULL) {
+        file->diagnostics = g_string_new(NULL);
+    }
 }
 
-TokenLocation new_location(unsigned long int line_start,
-                           unsigned long int col_start,
-                           unsigned long int line_end,
-                           unsigned long int col_end, ModuleFile* file) {
+void flush_diagnostics(ModuleFile* file) {
+    if (file->diagnostics == NULL) {
+        return;
+    }
+
+    GString* diagnostics = file->diagnostics;
+    file->diagnostics    = NULL;
+
+    fwrite(diagnostics->str, 1, diagnostics->len, stdout);
+    g_string_free(diagnostics, TRUE);
+}
+
+TokenLocation new_location(unsigned int line_start, unsigned int col_start,
+                           unsigned int line_end, unsigned int col_end,
+                           ModuleFile* file) {
     TokenLocation location;
 
     location.line_start = line_start;
@@ -297,7 +374,8 @@ void print_unit_statistics(ModuleFileStack* file_stack) {
     printf("\n\n");
 }
 
-void print_message(Message kind, const char* fmt, ...) {
+static void append_message(GString* output, Message kind, const char* fmt,
+                           va_list args) {
     const char* accent_color = RESET;
     const char* kind_text    = "unknown";
     switch (kind) {
@@ -315,14 +393,36 @@ void print_message(Message kind, const char* fmt, ...) {
             break;
     }
 
+    g_string_append_printf(output, "%s%s:%s ", accent_color, kind_text, RESET);
+    g_string_append_vprintf(output, fmt, args);
+    g_string_append_c(output, '\n');
+}
+
+void print_message(Message kind, const char* fmt, ...) {
+    GString* output = g_string_new(NULL);
+
     va_list args;
     va_start(args, fmt);
 
-    printf("%s%s:%s ", accent_color, kind_text, RESET);
-    vprintf(fmt, args);
-    printf("\n");
+    append_message(output, kind, fmt, args);
 
     va_end(args);
+
+    emit_diagnostic_output(NULL, output);
+}
+
+void print_file_message(ModuleFile* file, Message kind, const char* fmt,
+                        ...) {
+    GString* output = g_string_new(NULL);
+
+    va_list args;
+    va_start(args, fmt);
+
+    append_message(output, kind, fmt, args);
+
+    va_end(args);
+
+    emit_diagnostic_output(file, output);
 }
 
 int create_directory(const char* path) {
@@ -351,3 +451,229 @@ const char* get_absolute_path(const char* path) {
 
     return cached_canonical;
 }
+
+// modification time of directories that do not exist
+#define DIRECTORY_MISSING (-1)
+// modification time of directories which can not be determined
+#define DIRECTORY_UNKNOWN (-2)
+// coarsest timestamp resolution of supported filesystems in nanoseconds,
+// NFS and ext3 only store modification times in steps of one to two seconds
+#define DIRECTORY_TIME_GRANULARITY ((gint64) 2000000000)
+
+/**
+ * @brief Kind of an entry of a cached directory listing.
+ */
+typedef enum DirectoryEntryKind_t {
+    DirectoryEntryMissing = 0,
+    // listed but not checked whether the entry is a regular file
+    DirectoryEntryListed,
+    // regular file or symbolic link to one
+    DirectoryEntryFile,
+    // directories, sockets, fifos and broken symbolic links
+    DirectoryEntryOther
+} DirectoryEntryKind;
+
+/**
+ * @brief Cached listing of a directory.
+ */
+typedef struct DirectoryListing_t {
+    // names of all entries mapped to their kind
+    GHashTable* entries;
+    // modification time of the directory when it was listed
+    gint64 modified;
+    // real time at which the directory was listed
+    gint64 listed;
+} DirectoryListing;
+
+static GMutex directory_cache_lock;
+// maps canonical directory paths to their listing
+static GHashTable* directory_listings = NULL;
+// maps canonical file paths to the copy returned to callers
+static GHashTable* resolved_paths = NULL;
+
+static gint64 get_modification_time(const char* path) {
+#ifdef __unix__
+    struct stat status;
+    if (stat(path, &status) != 0) {
+        return DIRECTORY_MISSING;
+    }
+
+    return (gint64) status.st_mtim.tv_sec * 1000000000
+           + status.st_mtim.tv_nsec;
+#else
+    return DIRECTORY_UNKNOWN;
+#endif
+}
+
+static void read_directory_listing(DirectoryListing* listing,
+                                   const char* path) {
+    // taken before reading so that changes while reading are noticed later
+    listing->modified = get_modification_time(path);
+    listing->listed   = g_get_real_time() * 1000;
+
+    g_hash_table_remove_all(listing->entries);
+
+    GDir* dir = g_dir_open(path, 0, NULL);
+    if (dir == NULL) {
+        return;
+    }
+
+    const gchar* name = NULL;
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        g_hash_table_insert(listing->entries, g_strdup(name),
+                            GINT_TO_POINTER(DirectoryEntryListed));
+    }
+
+    g_dir_close(dir);
+}
+
+static DirectoryListing* get_directory_listing(const char* path) {
+    DirectoryListing* listing = g_hash_table_lookup(directory_listings, path);
+
+    if (listing == NULL) {
+        DEBUG("listing directory: %s", path);
+
+        listing = mem_alloc(MemoryNamespaceIo, sizeof(DirectoryListing));
+        listing->entries =
+          g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        read_directory_listing(listing, path);
+
+        g_hash_table_insert(directory_listings,
+                            mem_strdup(MemoryNamespaceIo, (char*) path),
+                            listing);
+    }
+
+    return listing;
+}
+
+/**
+ * @brief Test whether a directory can no longer be modified without its
+ *        modification time changing.
+ * @param listing cached listing of the directory
+ * @param now real time in nanoseconds
+ * @return true if the directory was missing or its modification time lies
+ *         more than one timestamp step before now
+ */
+static bool is_listing_settled(const DirectoryListing* listing, gint64 now) {
+    if (listing->modified == DIRECTORY_MISSING) {
+        // creating the directory changes its modification time
+        return true;
+    }
+
+    return listing->modified >= 0
+           && now - listing->modified > DIRECTORY_TIME_GRANULARITY;
+}
+
+static DirectoryEntryKind get_directory_entry_kind(const char* directory,
+                                                   const char* name) {
+    DirectoryListing* listing = get_directory_listing(directory);
+
+    DirectoryEntryKind kind =
+      GPOINTER_TO_INT(g_hash_table_lookup(listing->entries, name));
+
+    if (kind == DirectoryEntryMissing) {
+        // the entry may have been created after the directory was listed
+        const gint64 modified = get_modification_time(directory);
+        const bool unchanged =
+          modified != DIRECTORY_UNKNOWN && modified == listing->modified;
+
+        if (unchanged && is_listing_settled(listing, listing->listed)) {
+            return DirectoryEntryMissing;
+        }
+
+        if (!unchanged
+            || is_listing_settled(listing, g_get_real_time() * 1000)) {
+            DEBUG("listing modified directory: %s", directory);
+            read_directory_listing(listing, directory);
+
+            kind = GPOINTER_TO_INT(g_hash_table_lookup(listing->entries, name));
+        } else {
+            // files created within the same timestamp step as the listing
+            // do not change the modification time, test the entry itself
+            char* path = g_build_filename(directory, name, NULL);
+            if (g_file_test(path, G_FILE_TEST_EXISTS)) {
+                kind = DirectoryEntryListed;
+            }
+            g_free(path);
+        }
+    }
+
+    if (kind == DirectoryEntryListed) {
+        char* path = g_build_filename(directory, name, NULL);
+        kind       = g_file_test(path, G_FILE_TEST_IS_REGULAR)
+                       ? DirectoryEntryFile
+                       : DirectoryEntryOther;
+        g_free(path);
+
+        g_hash_table_insert(listing->entries, g_strdup(name),
+                            GINT_TO_POINTER(kind));
+    }
+
+    return kind;
+}
+
+static const char* get_resolved_path(const char* canonical) {
+    const char* path = g_hash_table_lookup(resolved_paths, canonical);
+
+    if (path == NULL) {
+        path = mem_strdup(MemoryNamespaceStatic, (char*) canonical);
+        g_hash_table_insert(resolved_paths, (gpointer) path, (gpointer) path);
+    }
+
+    return path;
+}
+
+const char* find_file_in_directories(const GArray* directories,
+                                     const char* name) {
+    g_mutex_lock(&directory_cache_lock);
+
+    if (directory_listings == NULL) {
+        directory_listings =
+          mem_new_g_hash_table(MemoryNamespaceIo, g_str_hash, g_str_equal);
+        resolved_paths =
+          mem_new_g_hash_table(MemoryNamespaceIo, g_str_hash, g_str_equal);
+    }
+
+    const char* found_path = NULL;
+
+    for (guint i = 0; i < directories->len && found_path == NULL; i++) {
+        const char* directory = g_array_index(directories, const char*, i);
+
+        char* path      = g_build_filename(directory, name, NULL);
+        // search directories are absolute, the cwd is never queried
+        char* canonical = g_canonicalize_filename(path, NULL);
+        char* parent    = g_path_get_dirname(canonical);
+        char* basename  = g_path_get_basename(canonical);
+
+        if (get_directory_entry_kind(parent, basename) == DirectoryEntryFile) {
+            found_path = get_resolved_path(canonical);
+        }
+
+        g_free(path);
+        g_free(canonical);
+        g_free(parent);
+        g_free(basename);
+    }
+
+    g_mutex_unlock(&directory_cache_lock);
+
+    return found_path;
+}
+
+void add_search_directory(GArray* directories, const char* directory) {
+    char* canonical = g_canonicalize_filename(directory, NULL);
+    bool contained  = false;
+
+    // all directories of the list are canonical already
+    for (guint i = 0; i < directories->len && !contained; i++) {
+        contained =
+          strcmp(canonical, g_array_index(directories, const char*, i)) == 0;
+    }
+
+    if (!contained) {
+        char* copy = mem_strdup(MemoryNamespaceOpt, canonical);
+        g_array_append_val(directories, copy);
+    }
+
+    g_free(canonical);
+}
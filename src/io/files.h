@@ -20,10 +20,29 @@ typedef struct FileDiagnosticStatistics_t {
     unsigned long int info_count;
 } FileDiagnosticStatistics;
 
+/**
+ * @brief Import of a module resolved through the import search directories.
+ */
+typedef struct ModuleImport_t {
+    // name of the file searched for
+    char* name;
+    // canonical path the name resolved to
+    char* path;
+} ModuleImport;
+
 typedef struct ModuleFile_t {
     const char* path;
     FILE* handle;
     FileDiagnosticStatistics statistics;
+    // diagnostics held back until flush_diagnostics() is called
+    // NULL if diagnostics are printed immediately
+    GString* diagnostics;
+    // content digest of the source the module was built from
+    // NULL until the source was read
+    char* digest;
+    // imports of the module in order of their resolution
+    // NULL if the module has no imports
+    GArray* imports;
 } ModuleFile;
 
 typedef struct ModuleFileStack_t {
@@ -33,11 +52,11 @@ typedef struct ModuleFileStack_t {
 typedef enum Message_t { Info, Warning, Error } Message;
 
 typedef struct TokenLocation_t {
-    unsigned long int line_start;
-    unsigned long int col_start;
-    unsigned long int line_end;
-    unsigned long int col_end;
     ModuleFile* file;
+    unsigned int line_start;
+    unsigned int col_start;
+    unsigned int line_end;
+    unsigned int col_end;
 } TokenLocation;
 
 /**
@@ -63,6 +82,15 @@ ModuleFile* push_file(ModuleFileStack* stack, const char* path);
 [[gnu::nonnull(1)]]
 void delete_files(ModuleFileStack* stack);
 
+/**
+ * @brief Record that an import of the file resolved to the given path.
+ * @param file importing module file
+ * @param name name of the file searched for
+ * @param path path the name resolved to
+ */
+[[gnu::nonnull(1), gnu::nonnull(2), gnu::nonnull(3)]]
+void add_file_import(ModuleFile* file, const char* name, const char* path);
+
 /**
  * Create a new token location
  * @param line_start
@@ -71,10 +99,9 @@ void delete_files(ModuleFileStack* stack);
  * @param col_end
  * @return
  */
-TokenLocation new_location(unsigned long int line_start,
-                           unsigned long int col_start,
-                           unsigned long int line_end,
-                           unsigned long int col_end, ModuleFile* file);
+TokenLocation new_location(unsigned int line_start, unsigned int col_start,
+                           unsigned int line_end, unsigned int col_end,
+                           ModuleFile* file);
 
 /**
  * @brief Create a new empty location with all of its contents set to zero
@@ -93,6 +120,34 @@ TokenLocation empty_location(ModuleFile* file);
 void print_diagnostic(TokenLocation* location, Message kind,
                       const char* message, ...);
 
+/**
+ * @brief Hold back all diagnostics of a file until flush_diagnostics() is
+ *        called. Used while files are parsed concurrently so that their
+ *        diagnostics can be printed in a fixed order.
+ * @param file
+ */
+[[gnu::nonnull(1)]]
+void buffer_diagnostics(ModuleFile* file);
+
+/**
+ * @brief Print all diagnostics held back for a file and print further
+ *        diagnostics immediately.
+ * @param file
+ */
+[[gnu::nonnull(1)]]
+void flush_diagnostics(ModuleFile* file);
+
+/**
+ * @brief Print a message about a file without source context. Held back
+ *        like the diagnostics of the file.
+ * @param file
+ * @param kind
+ * @param fmt
+ * @param ...
+ */
+[[gnu::nonnull(1), gnu::nonnull(3)]]
+void print_file_message(ModuleFile* file, Message kind, const char* fmt, ...);
+
 [[gnu::nonnull(2)]]
 /**
  * @brief Print a general message to stdout. Provides no source context like print_diagnostic()
@@ -142,4 +197,30 @@ const char* get_last_error();
 [[gnu::nonnull(1)]] [[nodiscard("pointer must be freed")]]
 const char* get_absolute_path(const char* path);
 
+/**
+ * @brief Search a file in a list of directories.
+ *        Listings of the searched directories are cached for the lifetime of
+ *        the process. A cached listing is only read again when a file is
+ *        missing from it and the directory was modified since. Misses in
+ *        directories modified shortly before they were listed are checked
+ *        on the filesystem, as their timestamps may not reflect new files.
+ * @param directories list of canonical directories to search in order
+ * @param name relative path of the file
+ * @return canonical path of the first regular file found or NULL
+ */
+[[gnu::nonnull(1), gnu::nonnull(2)]]
+const char* find_file_in_directories(const GArray* directories,
+                                     const char* name);
+
+/**
+ * @brief Append the canonical path of a directory to a list of search
+ *        directories unless the list already contains the same directory.
+ *        Relative directories are resolved against the current working
+ *        directory.
+ * @param directories list of canonical search directories
+ * @param directory directory to append
+ */
+[[gnu::nonnull(1), gnu::nonnull(2)]]
+void add_search_directory(GArray* directories, const char* directory);
+
 #endif // GEMSTONE_FILES_H
@@ -0,0 +1,342 @@
+
+#include <io/interface.h>
+#include <mem/cache.h>
+#include <mem/symbol.h>
+#include <string.h>
+#include <sys/log.h>
+
+// first string of every interface, bump when the format changes
+#define INTERFACE_HEADER "gsc-interface 1 " GSC_VERSION
+
+// index of a missing node value
+#define INTERFACE_NO_VALUE G_MAXUINT32
+
+// deepest nesting of nodes accepted, bounds the recursion of read_node()
+// as the interface may be corrupt
+#define INTERFACE_MAX_DEPTH 4096
+
+/**
+ * @brief Buffer an interface is serialized into.
+ */
+typedef struct InterfaceWriter_t {
+    GString* buffer;
+    // maps node values to their index in the string table
+    GHashTable* strings;
+    // node values in order of their index
+    GPtrArray* table;
+} InterfaceWriter;
+
+/**
+ * @brief Bounds checked cursor over a mapped interface.
+ */
+typedef struct InterfaceReader_t {
+    const char* data;
+    gsize length;
+    gsize offset;
+    // set once any read exceeds the interface
+    bool failed;
+    // string table of the interface
+    GPtrArray* strings;
+    ModuleFile* file;
+} InterfaceReader;
+
+char* interface_path(const char* path) {
+    return g_strjoin(".", path, INTERFACE_FILE_EXTENSION, NULL);
+}
+
+static void write_u32(GString* buffer, guint32 value) {
+    g_string_append_len(buffer, (const gchar*) &value, sizeof(value));
+}
+
+static void write_string(GString* buffer, const char* string) {
+    const guint32 length = (guint32) strlen(string);
+
+    write_u32(buffer, length);
+    g_string_append_len(buffer, string, length);
+}
+
+static guint32 read_u32(InterfaceReader* reader) {
+    guint32 value = 0;
+
+    if (reader->failed || reader->length - reader->offset < sizeof(value)) {
+        reader->failed = true;
+        return 0;
+    }
+
+    memcpy(&value, reader->data + reader->offset, sizeof(value));
+    reader->offset += sizeof(value);
+
+    return value;
+}
+
+/**
+ * @brief Read a length prefixed string without copying it.
+ * @param reader
+ * @param length output for the length of the string
+ * @return start of the string within the interface, not terminated
+ */
+static const char* read_string(InterfaceReader* reader, guint32* length) {
+    *length = read_u32(reader);
+
+    if (reader->failed || reader->length - reader->offset < *length) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    const char* string = reader->data + reader->offset;
+    reader->offset += *length;
+
+    return string;
+}
+
+static bool read_string_equals(InterfaceReader* reader, const char* expected) {
+    guint32 length     = 0;
+    const char* string = read_string(reader, &length);
+
+    return string != NULL && length == strlen(expected)
+           && memcmp(string, expected, length) == 0;
+}
+
+static guint32 get_string_index(InterfaceWriter* writer, const char* value) {
+    if (value == NULL) {
+        return INTERFACE_NO_VALUE;
+    }
+
+    gpointer index = NULL;
+    if (g_hash_table_lookup_extended(writer->strings, value, NULL, &index)) {
+        return GPOINTER_TO_UINT(index);
+    }
+
+    const guint32 new_index = writer->table->len;
+    g_ptr_array_add(writer->table, (gpointer) value);
+    g_hash_table_insert(writer->strings, (gpointer) value,
+                        GUINT_TO_POINTER(new_index));
+
+    return new_index;
+}
+
+static void collect_strings(InterfaceWriter* writer, const AST_NODE_PTR node) {
+    get_string_index(writer, node->value);
+
+    for (guint i = 0; i < node->children.len; i++) {
+        collect_strings(writer, node->children.data[i]);
+    }
+}
+
+static void write_node(InterfaceWriter* writer, const AST_NODE_PTR node) {
+    write_u32(writer->buffer, node->kind);
+    write_u32(writer->buffer, get_string_index(writer, node->value));
+    write_u32(writer->buffer, node->location.line_start);
+    write_u32(writer->buffer, node->location.col_start);
+    write_u32(writer->buffer, node->location.line_end);
+    write_u32(writer->buffer, node->location.col_end);
+    write_u32(writer->buffer, node->children.len);
+
+    for (guint i = 0; i < node->children.len; i++) {
+        write_node(writer, node->children.data[i]);
+    }
+}
+
+/**
+ * @brief Read a node and all of its children.
+ * @param reader
+ * @param depth nesting depth of the node
+ * @return node or NULL if the interface is malformed
+ */
+static AST_NODE_PTR read_node(InterfaceReader* reader, guint depth) {
+    if (depth > INTERFACE_MAX_DEPTH) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    const guint32 kind       = read_u32(reader);
+    const guint32 value      = read_u32(reader);
+    const guint32 line_start = read_u32(reader);
+    const guint32 col_start  = read_u32(reader);
+    const guint32 line_end   = read_u32(reader);
+    const guint32 col_end    = read_u32(reader);
+    const guint32 children   = read_u32(reader);
+
+    if (reader->failed || kind >= AST_ELEMENT_COUNT
+        || (value != INTERFACE_NO_VALUE && value >= reader->strings->len)) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    AST_NODE_PTR node = AST_new_node(
+      new_location(line_start, col_start, line_end, col_end, reader->file),
+      kind,
+      value == INTERFACE_NO_VALUE ? NULL : reader->strings->pdata[value]);
+
+    for (guint32 i = 0; i < children; i++) {
+        AST_NODE_PTR child = read_node(reader, depth + 1);
+        if (child == NULL) {
+            AST_delete_node(node);
+            return NULL;
+        }
+
+        AST_push_node(node, child);
+    }
+
+    return node;
+}
+
+/**
+ * @brief Check the header of the interface and its source digest.
+ * @param reader
+ * @param digest content digest of the module file
+ * @return true if the interface is up to date
+ */
+static bool read_header(InterfaceReader* reader, const char* digest) {
+    return read_string_equals(reader, INTERFACE_HEADER)
+           && read_u32(reader) == AST_ELEMENT_COUNT
+           && read_string_equals(reader, digest);
+}
+
+bool interface_load(AST_NODE_PTR module, ModuleFile* file) {
+    if (file->digest == NULL) {
+        return false;
+    }
+
+    char* path          = interface_path(file->path);
+    GMappedFile* mapped = g_mapped_file_new(path, FALSE, NULL);
+
+    if (mapped == NULL) {
+        g_free(path);
+        return false;
+    }
+
+    InterfaceReader reader;
+    reader.data    = g_mapped_file_get_contents(mapped);
+    reader.length  = g_mapped_file_get_length(mapped);
+    reader.offset  = 0;
+    reader.failed  = false;
+    reader.strings = g_ptr_array_new();
+    reader.file    = file;
+
+    bool loaded = read_header(&reader, file->digest);
+
+    if (loaded) {
+        const guint32 count = read_u32(&reader);
+
+        for (guint32 i = 0; i < count && !reader.failed; i++) {
+            guint32 length     = 0;
+            const char* string = read_string(&reader, &length);
+
+            if (string != NULL) {
+                const Symbol symbol = symbol_intern_length(string, length);
+                g_ptr_array_add(reader.strings, (gpointer) symbol);
+            }
+        }
+
+        // load into a separate module so that a malformed interface
+        // leaves the module untouched
+        AST_NODE_PTR loaded_module =
+          AST_new_node(empty_location(file), AST_Module, NULL);
+
+        const guint32 children = read_u32(&reader);
+        for (guint32 i = 0; i < children && !reader.failed; i++) {
+            AST_NODE_PTR child = read_node(&reader, 1);
+
+            if (child != NULL) {
+                AST_push_node(loaded_module, child);
+            }
+        }
+
+        loaded = !reader.failed;
+        if (loaded) {
+            AST_merge_modules(module, module->children.len, loaded_module);
+            INFO("loaded module interface: %s", path);
+        } else {
+            WARN("malformed module interface: %s", path);
+            AST_delete_node(loaded_module);
+        }
+    } else {
+        INFO("module interface is out of date: %s", path);
+    }
+
+    g_ptr_array_free(reader.strings, TRUE);
+    g_mapped_file_unref(mapped);
+    g_free(path);
+
+    return loaded;
+}
+
+static bool is_up_to_date(const char* path, const char* digest) {
+    GMappedFile* mapped = g_mapped_file_new(path, FALSE, NULL);
+
+    if (mapped == NULL) {
+        return false;
+    }
+
+    InterfaceReader reader;
+    reader.data    = g_mapped_file_get_contents(mapped);
+    reader.length  = g_mapped_file_get_length(mapped);
+    reader.offset  = 0;
+    reader.failed  = false;
+    reader.strings = NULL;
+    reader.file    = NULL;
+
+    bool up_to_date = read_header(&reader, digest);
+
+    g_mapped_file_unref(mapped);
+
+    return up_to_date;
+}
+
+int interface_write(const AST_NODE_PTR module, const ModuleFile* file) {
+    // digest of the source the syntax tree was parsed from
+    const char* digest = file->digest;
+    if (digest == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    char* path = interface_path(file->path);
+
+    if (is_up_to_date(path, digest)) {
+        g_free(path);
+        return EXIT_SUCCESS;
+    }
+
+    InterfaceWriter writer;
+    writer.buffer  = g_string_new(NULL);
+    writer.strings = g_hash_table_new(g_str_hash, g_str_equal);
+    writer.table   = g_ptr_array_new();
+
+    write_string(writer.buffer, INTERFACE_HEADER);
+    write_u32(writer.buffer, AST_ELEMENT_COUNT);
+    write_string(writer.buffer, digest);
+
+    for (guint i = 0; i < module->children.len; i++) {
+        collect_strings(&writer, module->children.data[i]);
+    }
+
+    write_u32(writer.buffer, writer.table->len);
+    for (guint i = 0; i < writer.table->len; i++) {
+        write_string(writer.buffer, writer.table->pdata[i]);
+    }
+
+    write_u32(writer.buffer, module->children.len);
+    for (guint i = 0; i < module->children.len; i++) {
+        write_node(&writer, module->children.data[i]);
+    }
+
+    int status    = EXIT_SUCCESS;
+    GError* error = NULL;
+    if (!g_file_set_contents(path, writer.buffer->str,
+                             (gssize) writer.buffer->len, &error)) {
+        print_message(Warning, "Unable to write module interface %s: %s",
+                      path, error->message);
+        g_error_free(error);
+        status = EXIT_FAILURE;
+    } else {
+        print_message(Info, "Module interface was written to: %s", path);
+    }
+
+    g_string_free(writer.buffer, TRUE);
+    g_hash_table_destroy(writer.strings);
+    g_ptr_array_free(writer.table, TRUE);
+    g_free(path);
+
+    return status;
+}
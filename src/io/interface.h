@@ -0,0 +1,48 @@
+//
+// Module interface files. The syntax tree of a module file can be written
+// to a binary interface file next to it. As long as the content of the
+// module file is unchanged its syntax tree is loaded from the interface
+// instead of lexing and parsing the file again.
+//
+
+#ifndef GEMSTONE_INTERFACE_H
+#define GEMSTONE_INTERFACE_H
+
+#include <ast/ast.h>
+#include <io/files.h>
+
+#define INTERFACE_FILE_EXTENSION "gsci"
+
+/**
+ * @brief Get the path of the interface file of a module file.
+ * @param path path to the module file
+ * @return path which must be freed with g_free()
+ */
+[[nodiscard("must be freed")]] [[gnu::nonnull(1)]]
+char* interface_path(const char* path);
+
+/**
+ * @brief Load the syntax tree of the module file from its interface file
+ *        if there is an interface which is up to date.
+ *        Malformed interfaces are not loaded, including those that nest
+ *        nodes deeper than any parsed module would.
+ * @param module module node to append the loaded nodes to
+ * @param file the module file to load the interface of, its content
+ *             digest must have been computed
+ * @return true if the syntax tree was loaded from the interface
+ */
+[[gnu::nonnull(1), gnu::nonnull(2)]]
+bool interface_load(AST_NODE_PTR module, ModuleFile* file);
+
+/**
+ * @brief Write the syntax tree of the module file to its interface file,
+ *        unless the interface is already up to date.
+ * @param module parsed module node of the file
+ * @param file the module file the syntax tree was parsed from, its content
+ *             digest must have been computed
+ * @return EXIT_SUCCESS if successful EXIT_FAILURE otherwise
+ */
+[[gnu::nonnull(1), gnu::nonnull(2)]]
+int interface_write(const AST_NODE_PTR module, const ModuleFile* file);
+
+#endif // GEMSTONE_INTERFACE_H
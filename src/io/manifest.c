@@ -0,0 +1,289 @@
+
+#include <assert.h>
+#include <glib/gstdio.h>
+#include <io/manifest.h>
+#include <mem/cache.h>
+#include <string.h>
+#include <sys/log.h>
+
+// first line of every manifest, bump when the format changes
+#define MANIFEST_HEADER "gsc-manifest 2 " GSC_VERSION
+
+#define MANIFEST_CHECKSUM G_CHECKSUM_SHA256
+
+// content digest and path of a module file
+#define MANIFEST_RECORD_FILE "file"
+// import search directory of the target
+#define MANIFEST_RECORD_DIRECTORY "directory"
+// name of an imported file and the path it resolved to
+#define MANIFEST_RECORD_IMPORT "import"
+
+// maximum number of tab separated fields of a record
+#define MANIFEST_RECORD_FIELDS 3
+
+static char* get_manifest_path(const TargetConfig* target) {
+    char* basename =
+      g_strjoin(".", target->name, MANIFEST_FILE_EXTENSION, NULL);
+    char* path = g_build_filename(target->archive_directory, basename, NULL);
+    g_free(basename);
+
+    return path;
+}
+
+/**
+ * @brief Split a record of the manifest into its fields in place.
+ * @param line record to split
+ * @param fields output for the fields
+ * @return number of fields or MANIFEST_RECORD_FIELDS + 1 if there are more
+ */
+static guint split_record(char* line, char* fields[MANIFEST_RECORD_FIELDS]) {
+    guint count = 0;
+
+    while (line != NULL) {
+        if (count == MANIFEST_RECORD_FIELDS) {
+            return MANIFEST_RECORD_FIELDS + 1;
+        }
+
+        fields[count++] = line;
+
+        char* separator = strchr(line, '\t');
+        if (separator != NULL) {
+            *separator = '\0';
+            separator++;
+        }
+        line = separator;
+    }
+
+    return count;
+}
+
+static void checksum_update_string(GChecksum* checksum, const char* string) {
+    if (string == NULL) {
+        string = "";
+    }
+
+    // include terminator to separate adjacent values
+    g_checksum_update(checksum, (const guint8*) string,
+                      (gssize) strlen(string) + 1);
+}
+
+static void checksum_update_paths(GChecksum* checksum, const GArray* paths) {
+    for (guint i = 0; i < paths->len; i++) {
+        checksum_update_string(checksum, g_array_index(paths, char*, i));
+    }
+
+    checksum_update_string(checksum, "");
+}
+
+char* manifest_config_digest(const TargetConfig* target) {
+    GChecksum* checksum = g_checksum_new(MANIFEST_CHECKSUM);
+
+    char* options = g_strdup_printf(
+      "%d %d %d %d %d %d %d %d %d %d %d", target->print_ast,
+      target->print_asm, target->print_ir, target->mode,
+      target->optimization_level, target->lld_fatal_warnings,
+      target->gsc_fatal_warnings, target->separate_compilation,
+      target->codegen_shards, target->lto, target->keep_intermediates);
+
+    checksum_update_string(checksum, MANIFEST_HEADER);
+    checksum_update_string(checksum, options);
+    checksum_update_string(checksum, target->name);
+    checksum_update_string(checksum, target->root_module);
+    checksum_update_string(checksum, target->output_directory);
+    checksum_update_string(checksum, target->archive_directory);
+    checksum_update_string(checksum, target->driver);
+    checksum_update_string(checksum, target->opt_pipeline);
+    checksum_update_paths(checksum, target->link_search_paths);
+    checksum_update_paths(checksum, target->import_paths);
+
+    g_free(options);
+
+    char* digest = g_strdup(g_checksum_get_string(checksum));
+    g_checksum_free(checksum);
+
+    return digest;
+}
+
+char* manifest_data_digest(const void* data, gsize length) {
+    return g_compute_checksum_for_data(MANIFEST_CHECKSUM, data, length);
+}
+
+char* manifest_file_digest(const char* path) {
+    gchar* content = NULL;
+    gsize length   = 0;
+
+    if (!g_file_get_contents(path, &content, &length, NULL)) {
+        return NULL;
+    }
+
+    char* digest = manifest_data_digest(content, length);
+    g_free(content);
+
+    return digest;
+}
+
+static bool artifact_exists(const char* directory, const char* name,
+                            const char* extension) {
+    char* basename = g_strjoin(".", name, extension, NULL);
+    char* path     = g_build_filename(directory, basename, NULL);
+
+    bool exists = g_file_test(path, G_FILE_TEST_IS_REGULAR);
+    if (!exists) {
+        INFO("missing build artifact: %s", path);
+    }
+
+    g_free(basename);
+    g_free(path);
+
+    return exists;
+}
+
+bool manifest_is_up_to_date(const TargetConfig* target,
+                            const char* config_digest) {
+    char* path      = get_manifest_path(target);
+    gchar* content  = NULL;
+    bool up_to_date = FALSE;
+
+    if (!g_file_get_contents(path, &content, NULL, NULL)) {
+        INFO("no build manifest for target: %s", target->name);
+        g_free(path);
+        return FALSE;
+    }
+
+    gchar** lines = g_strsplit(content, "\n", -1);
+    g_free(content);
+
+    // search directories the imports were resolved with
+    GArray* directories = g_array_new(FALSE, FALSE, sizeof(char*));
+
+    // header and configuration digest are followed by one record per line
+    // consisting of its kind and fields separated by tabs
+    if (g_strv_length(lines) < 3 || strcmp(lines[0], MANIFEST_HEADER) != 0
+        || strcmp(lines[1], config_digest) != 0) {
+        INFO("configuration of target changed: %s", target->name);
+        goto cleanup;
+    }
+
+    for (guint i = 2; lines[i] != NULL && lines[i][0] != '\0'; i++) {
+        char* fields[MANIFEST_RECORD_FIELDS] = {NULL};
+
+        const guint count = split_record(lines[i], fields);
+
+        if (count == 3 && strcmp(fields[0], MANIFEST_RECORD_FILE) == 0) {
+            char* digest   = manifest_file_digest(fields[2]);
+            bool unchanged = digest != NULL && strcmp(digest, fields[1]) == 0;
+            g_free(digest);
+
+            if (!unchanged) {
+                INFO("module file changed: %s", fields[2]);
+                goto cleanup;
+            }
+
+        } else if (count == 2
+                   && strcmp(fields[0], MANIFEST_RECORD_DIRECTORY) == 0) {
+            g_array_append_val(directories, fields[1]);
+
+        } else if (count == 3
+                   && strcmp(fields[0], MANIFEST_RECORD_IMPORT) == 0) {
+            // a file added to a preceding directory shadows the import
+            const char* resolved =
+              find_file_in_directories(directories, fields[1]);
+
+            if (resolved == NULL || strcmp(resolved, fields[2]) != 0) {
+                INFO("import resolves differently: %s", fields[1]);
+                goto cleanup;
+            }
+
+        } else {
+            WARN("malformed build manifest: %s", path);
+            goto cleanup;
+        }
+    }
+
+    // objects of applications are intermediates which may only have
+    // existed in memory, the linked executable is what counts
+    if (target->mode == Application) {
+        up_to_date =
+          artifact_exists(target->output_directory, target->name, "out");
+    } else {
+        up_to_date =
+          artifact_exists(target->archive_directory, target->name, "o");
+    }
+
+cleanup:
+    g_array_free(directories, TRUE);
+    g_strfreev(lines);
+    g_free(path);
+
+    return up_to_date;
+}
+
+int manifest_write(const TargetConfig* target, const char* config_digest,
+                   const ModuleFileStack* unit, guint first_file) {
+    assert(unit->files != NULL);
+
+    GString* manifest = g_string_new(MANIFEST_HEADER "\n");
+    g_string_append_printf(manifest, "%s\n", config_digest);
+
+    for (guint i = first_file; i < unit->files->len; i++) {
+        const ModuleFile* file = g_array_index(unit->files, ModuleFile*, i);
+
+        // the digest of the source that was built, the file may have been
+        // changed on disk since
+        if (file->digest == NULL) {
+            WARN("no content digest of module file: %s", file->path);
+            g_string_free(manifest, TRUE);
+            return EXIT_FAILURE;
+        }
+
+        g_string_append_printf(manifest, MANIFEST_RECORD_FILE "\t%s\t%s\n",
+                               file->digest, file->path);
+    }
+
+    // directories must precede the imports resolved through them
+    for (guint i = 0; i < target->import_paths->len; i++) {
+        g_string_append_printf(manifest, MANIFEST_RECORD_DIRECTORY "\t%s\n",
+                               g_array_index(target->import_paths, char*, i));
+    }
+
+    for (guint i = first_file; i < unit->files->len; i++) {
+        const ModuleFile* file = g_array_index(unit->files, ModuleFile*, i);
+
+        for (guint k = 0; file->imports != NULL && k < file->imports->len;
+             k++) {
+            const ModuleImport* import =
+              &g_array_index(file->imports, ModuleImport, k);
+
+            g_string_append_printf(manifest,
+                                   MANIFEST_RECORD_IMPORT "\t%s\t%s\n",
+                                   import->name, import->path);
+        }
+    }
+
+    char* path = get_manifest_path(target);
+    int status = EXIT_SUCCESS;
+
+    GError* error = NULL;
+    if (!g_file_set_contents(path, manifest->str, (gssize) manifest->len,
+                             &error)) {
+        print_message(Warning, "Unable to write build manifest: %s",
+                      error->message);
+        g_error_free(error);
+        status = EXIT_FAILURE;
+    }
+
+    g_free(path);
+    g_string_free(manifest, TRUE);
+
+    return status;
+}
+
+void manifest_discard(const TargetConfig* target) {
+    char* path = get_manifest_path(target);
+
+    if (g_remove(path) == 0) {
+        DEBUG("removed build manifest: %s", path);
+    }
+
+    g_free(path);
+}
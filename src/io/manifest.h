@@ -0,0 +1,85 @@
+//
+// Build cache manifests. After a successful build of a target a manifest is
+// written to its archive directory which records a digest of the target
+// configuration, the content digest of every module file the build read
+// and the path every import resolved to. As long as none of them changed
+// the artifacts of the previous build are reused.
+//
+
+#ifndef GEMSTONE_MANIFEST_H
+#define GEMSTONE_MANIFEST_H
+
+#include <cfg/opt.h>
+#include <glib.h>
+#include <io/files.h>
+
+#define MANIFEST_FILE_EXTENSION "cache"
+
+/**
+ * @brief Compute a digest of all options of the target that influence
+ *        its build artifacts.
+ * @attention Must be computed before the target is built, as building
+ *            extends the import paths of the target.
+ * @param target
+ * @return digest string which must be freed with g_free()
+ */
+[[nodiscard("must be freed")]] [[gnu::nonnull(1)]]
+char* manifest_config_digest(const TargetConfig* target);
+
+/**
+ * @brief Compute the digest of a block of data as recorded in build
+ *        manifests.
+ * @param data
+ * @param length number of bytes
+ * @return digest string which must be freed with g_free()
+ */
+[[nodiscard("must be freed")]]
+char* manifest_data_digest(const void* data, gsize length);
+
+/**
+ * @brief Compute the digest of the content of a file as recorded in
+ *        build manifests.
+ * @param path
+ * @return digest string which must be freed with g_free() or NULL if the
+ *         file cannot be read
+ */
+[[nodiscard("must be freed")]] [[gnu::nonnull(1)]]
+char* manifest_file_digest(const char* path);
+
+/**
+ * @brief Check whether the artifacts of the last build of the target are
+ *        still up to date: the configuration digest must match, every
+ *        recorded module file must have its recorded content, every
+ *        recorded import must still resolve to the same file and all
+ *        artifacts must exist.
+ * @param target
+ * @param config_digest digest of the current configuration
+ * @return TRUE if the target does not need to be rebuilt
+ */
+[[gnu::nonnull(1), gnu::nonnull(2)]]
+bool manifest_is_up_to_date(const TargetConfig* target,
+                            const char* config_digest);
+
+/**
+ * @brief Write the manifest of the target after a successful build.
+ *        Files are recorded with the digest of the source they were built
+ *        from, not with their current content.
+ * @param target
+ * @param config_digest digest computed before the build
+ * @param unit file stack the target was built with
+ * @param first_file index of the root module of the target in the stack
+ * @return EXIT_SUCCESS if successful EXIT_FAILURE otherwise
+ */
+[[gnu::nonnull(1), gnu::nonnull(2), gnu::nonnull(3)]]
+int manifest_write(const TargetConfig* target, const char* config_digest,
+                   const ModuleFileStack* unit, guint first_file);
+
+/**
+ * @brief Remove the manifest of the target, if any. Must be done before
+ *        rebuilding so that a failed build is never considered up to date.
+ * @param target
+ */
+[[gnu::nonnull(1)]]
+void manifest_discard(const TargetConfig* target);
+
+#endif // GEMSTONE_MANIFEST_H
@@ -1,89 +1,173 @@
 
 #include <glib.h>
+#include <io/manifest.h>
 #include <lex/util.h>
 #include <mem/cache.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/log.h>
+
+#ifdef __unix__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// number of null bytes flex requires at the end of a scan buffer
+#define SOURCE_PADDING 2
+
+void lex_init_context(ParseContext* context, AST_NODE_PTR root,
+                      ModuleFile* file) {
+    context->root        = root;
+    context->file        = file;
+    context->source      = NULL;
+    context->source_size = 0;
+    context->mapped      = false;
+    context->line_offset = 0;
+    context->line_start  = 0;
+    context->line        = 1;
+}
 
-// implementation based on:
-// https://github.com/sunxfancy/flex-bison-examples/blob/master/error-handling/ccalc.c
+static int read_source(ParseContext* context) {
+    FILE* handle = context->file->handle;
 
-char* buffer = NULL;
+    if (fseek(handle, 0, SEEK_END) != 0) {
+        return -1;
+    }
 
-static int eof             = 0;
-static int nRow            = 0;
-static int nBuffer         = 0;
-static int lBuffer         = 0;
-static int nTokenStart     = 0;
-static int nTokenLength    = 0;
-static int nTokenNextStart = 0;
+    long size = ftell(handle);
+    if (size < 0) {
+        return -1;
+    }
+    rewind(handle);
 
-void lex_init(void) {
-    buffer = mem_alloc(MemoryNamespaceStatic, MAX_READ_BUFFER_SIZE);
-}
+    char* source = malloc(size + SOURCE_PADDING);
+    if (source == NULL) {
+        return -1;
+    }
+
+    if (fread(source, 1, size, handle) != (size_t) size) {
+        free(source);
+        return -1;
+    }
+
+    memset(source + size, 0, SOURCE_PADDING);
+
+    context->source      = source;
+    context->source_size = size;
+    context->mapped      = false;
 
-void lex_reset(void) {
-    eof             = 0;
-    nRow            = 0;
-    nBuffer         = 0;
-    lBuffer         = 0;
-    nTokenStart     = 0;
-    nTokenLength    = 0;
-    nTokenNextStart = 0;
+    return 0;
 }
 
-void beginToken(char* t) {
-    nTokenStart     = nTokenNextStart;
-    nTokenLength    = (int) strlen(t);
-    nTokenNextStart = nBuffer + 1;
+#ifdef __unix__
+
+static int map_source(ParseContext* context) {
+    const int fd = fileno(context->file->handle);
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+        return -1;
+    }
+
+    const size_t size      = status.st_size;
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+
+    // bytes past the end of the file are only zero filled up to the end of
+    // the last page. If the padding does not fit the file cannot be mapped.
+    if (size == 0 || page_size - size % page_size < SOURCE_PADDING
+        || size % page_size == 0) {
+        return -1;
+    }
+
+    // private writable mapping as flex temporarily modifies its buffer
+    char* source = mmap(NULL, size + SOURCE_PADDING, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE, fd, 0);
+    if (source == MAP_FAILED) {
+        return -1;
+    }
 
-    yylloc.first_line   = nRow;
-    yylloc.first_column = nTokenStart;
-    yylloc.last_line    = nRow;
-    yylloc.last_column  = nTokenStart + nTokenLength - 1;
+    context->source      = source;
+    context->source_size = size;
+    context->mapped      = true;
+
+    return 0;
 }
 
-int nextChar(char* dst) {
-    int frc;
+#endif
+
+int lex_load_source(ParseContext* context) {
+    int status = -1;
 
-    if (eof) {
-        return 0;
+#ifdef __unix__
+    status = map_source(context);
+    if (status == 0) {
+        DEBUG("mapped %ld bytes of file: %s", context->source_size,
+              context->file->path);
     }
+#endif
 
-    while (nBuffer >= lBuffer) {
-        frc = getNextLine();
-        if (frc != 0) {
-            return 0;
-        }
+    if (status != 0) {
+        status = read_source(context);
     }
 
-    dst[0] = buffer[nBuffer];
-    nBuffer += 1;
+    if (status == 0) {
+        // digest of exactly the bytes which are parsed
+        g_free(context->file->digest);
+        context->file->digest =
+          manifest_data_digest(context->source, context->source_size);
+    }
 
-    return dst[0] != 0;
+    return status;
 }
 
-int getNextLine(void) {
-    char* p;
-
-    nBuffer         = 0;
-    nTokenStart     = -1;
-    nTokenNextStart = 1;
-    eof             = 0;
-
-    p = fgets(buffer, MAX_READ_BUFFER_SIZE, yyin);
-    if (p == NULL) {
-        if (ferror(yyin)) {
-            return -1;
-        }
-        eof = 1;
-        return 1;
+void lex_release_source(ParseContext* context) {
+    if (context->source == NULL) {
+        return;
     }
 
-    nRow += 1;
-    lBuffer = (int) strlen(buffer);
+#ifdef __unix__
+    if (context->mapped) {
+        munmap(context->source, context->source_size + SOURCE_PADDING);
+        context->source = NULL;
+        return;
+    }
+#endif
 
-    return 0;
+    free(context->source);
+    context->source = NULL;
+}
+
+// count line breaks up to (excluding) the given offset
+static void advance_lines(ParseContext* context, size_t offset) {
+    const char* cursor = context->source + context->line_offset;
+    const char* end    = context->source + offset;
+
+    while (cursor < end
+           && (cursor = memchr(cursor, '\n', end - cursor)) != NULL) {
+        cursor++;
+        context->line++;
+        context->line_start = cursor - context->source;
+    }
+
+    if (offset > context->line_offset) {
+        context->line_offset = offset;
+    }
+}
+
+void beginToken(ParseContext* context, YYLTYPE* location, const char* t,
+                size_t length) {
+    const size_t offset = t - context->source;
+
+    advance_lines(context, offset);
+    location->first_line   = (int) context->line;
+    location->first_column = (int) (offset - context->line_start + 1);
+
+    const size_t last = length > 0 ? offset + length - 1 : offset;
+
+    advance_lines(context, last);
+    location->last_line   = (int) context->line;
+    location->last_column = (int) (last - context->line_start + 1);
 }
 
 struct ConstEscSeq {
@@ -2,39 +2,81 @@
 #ifndef LEX_UTIL_H_
 #define LEX_UTIL_H_
 
+#include <ast/ast.h>
+#include <io/files.h>
 #include <stdio.h>
 #include <yacc/parser.tab.h>
 
-#define MAX_READ_BUFFER_SIZE 1000
-
-extern FILE* yyin;
-extern YYLTYPE yylloc;
-extern char* buffer;
+/**
+ * @brief State of a single parse. Every file parsed gets its own context
+ *        so that multiple files can be lexed and parsed concurrently.
+ */
+typedef struct ParseContext_t {
+    // module node used by the parser for AST construction
+    AST_NODE_PTR root;
+    // file which is parsed
+    ModuleFile* file;
+    // entire content of the file followed by two null bytes
+    char* source;
+    // size of the file in bytes
+    size_t source_size;
+    // whether source is memory mapped or allocated
+    bool mapped;
+    // offset up to which line breaks have been counted
+    size_t line_offset;
+    // offset of the first character of the current line
+    size_t line_start;
+    unsigned long line;
+} ParseContext;
 
 /**
- * @brief Initialize global state needed for the lexer
+ * @brief Initialize the context for parsing the given file into root.
+ * @param context
+ * @param root
+ * @param file
  */
-void lex_init(void);
+[[gnu::nonnull(1), gnu::nonnull(2), gnu::nonnull(3)]]
+void lex_init_context(ParseContext* context, AST_NODE_PTR root,
+                      ModuleFile* file);
 
-void lex_reset(void);
+/**
+ * @brief Lex and parse the file of the supplied context.
+ *        The source must have been loaded with lex_load_source().
+ * @param context
+ * @return 0 if parsing was successful anything else if not
+ */
+[[gnu::nonnull(1)]]
+int lex_parse_file(ParseContext* context);
 
 /**
- * @brief Begin counting a new token. This will fill the global struct yylloc.
- * @param t the text of the token. Must be null terminated
+ * @brief Load the source of the file into memory. On unix systems the file
+ *        is memory mapped, otherwise it is read at once. The content digest
+ *        of the file is set from the loaded source.
+ * @param context
+ * @return 0 if successful, anything else otherwise
  */
 [[gnu::nonnull(1)]]
-void beginToken(char* t);
+int lex_load_source(ParseContext* context);
 
 /**
- * @brief Stores the next character into the supplied buffer
- * @param dst the buffer to store character in
+ * @brief Release the source previously loaded by lex_load_source().
+ * @param context
  */
-int nextChar(char* dst);
+[[gnu::nonnull(1)]]
+void lex_release_source(ParseContext* context);
 
 /**
- * @brief Reads the next line from yyin into a global buffer
+ * @brief Begin counting a new token. This will fill the supplied location.
+ *        Lines and columns are derived from the offset of the token into the
+ *        source.
+ * @param context
+ * @param location
+ * @param t the text of the token, must point into the source
+ * @param length number of bytes of the token
  */
-int getNextLine(void);
+[[gnu::nonnull(1), gnu::nonnull(2), gnu::nonnull(3)]]
+void beginToken(ParseContext* context, YYLTYPE* location, const char* t,
+                size_t length);
 
 char* collapse_escape_sequences(char* string);
 
@@ -18,6 +18,21 @@ bool clang_link(TargetLinkConfig* config) {
                         g_array_index(config->object_file_names, char*, i));
     }
 
+    switch (config->lto) {
+        case LTOModeThin:
+            g_string_append_printf(commandString,
+                                   " -flto=thin -fuse-ld=lld -O%d",
+                                   config->optimization_level);
+            break;
+        case LTOModeFull:
+            g_string_append_printf(commandString,
+                                   " -flto=full -fuse-ld=lld -O%d",
+                                   config->optimization_level);
+            break;
+        default:
+            break;
+    }
+
     g_string_append(commandString, " -o ");
     g_string_append(commandString, config->output_file);
 
@@ -36,8 +51,9 @@ BinaryDriver* clang_get_driver() {
 
     BinaryDriver* driver = mem_alloc(MemoryNamespaceLld, sizeof(BinaryDriver));
 
-    driver->name      = "clang";
-    driver->link_func = &clang_link;
+    driver->name       = "clang";
+    driver->link_func  = &clang_link;
+    driver->in_process = false;
 
     return driver;
 }
@@ -7,7 +7,11 @@
 
 #include <cfg/opt.h>
 
+#ifdef GSC_LLD_DRIVER
+#define DEFAULT_DRIVER "lld"
+#else
 #define DEFAULT_DRIVER "clang"
+#endif
 
 //! @brief Function a binary driver used to link files
 typedef bool (*driver_link)(TargetLinkConfig*);
@@ -15,6 +19,9 @@ typedef bool (*driver_link)(TargetLinkConfig*);
 typedef struct BinaryDriver_t {
     const char* name;
     driver_link link_func;
+    // links within the compiler process and is thus able to read
+    // object files from memory
+    bool in_process;
 } BinaryDriver;
 
 #endif // GEMSTONE_DRIVER_H
@@ -8,6 +8,12 @@
 
 bool gcc_link(TargetLinkConfig* config) {
 
+    if (config->lto != LTOModeNone) {
+        print_message(Error, "gcc cannot link LLVM bitcode, use the clang "
+                             "driver for link time optimization");
+        return false;
+    }
+
     GString* commandString = g_string_new("");
 
     g_string_append(commandString, "gcc");
@@ -36,8 +42,9 @@ BinaryDriver* gcc_get_driver() {
 
     BinaryDriver* driver = mem_alloc(MemoryNamespaceLld, sizeof(BinaryDriver));
 
-    driver->name      = "gcc";
-    driver->link_func = &gcc_link;
+    driver->name       = "gcc";
+    driver->link_func  = &gcc_link;
+    driver->in_process = false;
 
     return driver;
 }
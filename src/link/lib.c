@@ -6,10 +6,15 @@
 #include <link/clang/driver.h>
 #include <link/gcc/driver.h>
 #include <link/lib.h>
+#include <link/lld/driver.h>
 #include <mem/cache.h>
 #include <sys/log.h>
 
-static driver_init AVAILABLE_DRIVER[] = {clang_get_driver, gcc_get_driver};
+static driver_init AVAILABLE_DRIVER[] = {clang_get_driver, gcc_get_driver,
+#ifdef GSC_LLD_DRIVER
+                                         lld_get_driver
+#endif
+};
 
 static GHashTable* binary_driver = NULL;
 
@@ -58,6 +63,24 @@ bool link_run(TargetLinkConfig* config) {
     }
 }
 
+bool link_objects_in_memory(const TargetConfig* config) {
+#ifndef __linux__
+    // objects are passed to the linker as memory files created by
+    // memfd_create(), elsewhere they are written to the archive directory
+    return false;
+#endif
+
+    if (config->mode != Application || config->keep_intermediates
+        || config->print_asm || binary_driver == NULL) {
+        return false;
+    }
+
+    const BinaryDriver* driver =
+      g_hash_table_lookup(binary_driver, config->driver);
+
+    return driver != NULL && driver->in_process;
+}
+
 void link_print_available_driver() {
     printf("Available binary driver:\n");
 
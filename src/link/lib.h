@@ -13,6 +13,17 @@ void link_init();
 
 bool link_run(TargetLinkConfig*);
 
+/**
+ * @brief Check whether the object files of the target are passed to the
+ *        binary driver from memory instead of the archive directory.
+ *        This requires an in-process driver, that no intermediate
+ *        files were requested and memory files, which are only available
+ *        on Linux.
+ * @param config
+ * @return true if object files need not to be written to disk
+ */
+bool link_objects_in_memory(const TargetConfig* config);
+
 void link_print_available_driver();
 
 #endif // GEMSTONE_LIB_H
@@ -0,0 +1,118 @@
+#include <link/lld/driver.h>
+
+#ifdef GSC_LLD_DRIVER
+
+#include <io/files.h>
+#include <lldcl.h>
+#include <mem/cache.h>
+#include <stdlib.h>
+
+#define ARG(argv, arg) g_ptr_array_add(argv, (gpointer) (arg))
+
+/**
+ * @brief Forward each line of the captured lld output as message.
+ * @param output diagnostics returned by lld
+ * @param kind message kind to print lines with
+ */
+static void print_lld_output(const char* output, Message kind) {
+    gchar** lines = g_strsplit(output, "\n", -1);
+
+    for (guint i = 0; lines[i] != NULL; i++) {
+        if (lines[i][0] != '\0') {
+            print_message(kind, "lld: %s", lines[i]);
+        }
+    }
+
+    g_strfreev(lines);
+}
+
+bool lld_link(TargetLinkConfig* config) {
+    GPtrArray* argv = g_ptr_array_new();
+
+    // flavor is derived from the program name
+    ARG(argv, "ld.lld");
+    ARG(argv, "--eh-frame-hdr");
+    ARG(argv, "-dynamic-linker");
+    ARG(argv, GSC_LLD_DYNAMIC_LINKER);
+    ARG(argv, config->colorize ? "--color-diagnostics"
+                               : "--no-color-diagnostics");
+
+    if (config->fatal_warnings) {
+        ARG(argv, "--fatal-warnings");
+    }
+
+    // bitcode objects are optimized and compiled by lld itself
+    char* lto_level = NULL;
+    if (config->lto != LTOModeNone) {
+        lto_level = g_strdup_printf("--lto-O%d", config->optimization_level);
+        ARG(argv, lto_level);
+    }
+
+    ARG(argv, "-o");
+    ARG(argv, config->output_file);
+
+    ARG(argv, GSC_LLD_CRT1);
+    ARG(argv, GSC_LLD_CRTI);
+    ARG(argv, GSC_LLD_CRTBEGIN);
+
+    char* libgcc_dir     = g_path_get_dirname(GSC_LLD_LIBGCC);
+    char* libc_dir       = g_path_get_dirname(GSC_LLD_LIBC);
+    char* libgcc_dir_arg = g_strconcat("-L", libgcc_dir, NULL);
+    char* libc_dir_arg   = g_strconcat("-L", libc_dir, NULL);
+    ARG(argv, libgcc_dir_arg);
+    ARG(argv, libc_dir_arg);
+
+    for (guint i = 0; i < config->object_file_names->len; i++) {
+        ARG(argv, g_array_index(config->object_file_names, char*, i));
+    }
+
+    ARG(argv, "-lgcc");
+    ARG(argv, "--as-needed");
+    ARG(argv, "-lgcc_s");
+    ARG(argv, "--no-as-needed");
+    ARG(argv, "-lc");
+    ARG(argv, "-lgcc");
+    ARG(argv, "--as-needed");
+    ARG(argv, "-lgcc_s");
+    ARG(argv, "--no-as-needed");
+
+    ARG(argv, GSC_LLD_CRTEND);
+    ARG(argv, GSC_LLD_CRTN);
+
+    const int argc = (int) argv->len;
+    ARG(argv, NULL);
+
+    gchar* command = g_strjoinv(" ", (gchar**) argv->pdata);
+    print_message(Info, "invoking binary link with: %s", command);
+    g_free(command);
+
+    const char* output = NULL;
+    const int exit_code = lld_main(argc, (const char**) argv->pdata, &output);
+
+    if (output != NULL) {
+        print_lld_output(output, exit_code == 0 ? Warning : Error);
+        free((void*) output);
+    }
+
+    g_free(lto_level);
+    g_free(libgcc_dir);
+    g_free(libc_dir);
+    g_free(libgcc_dir_arg);
+    g_free(libc_dir_arg);
+    g_ptr_array_free(argv, TRUE);
+
+    return exit_code == 0;
+}
+
+BinaryDriver* lld_get_driver() {
+
+    BinaryDriver* driver = mem_alloc(MemoryNamespaceLld, sizeof(BinaryDriver));
+
+    driver->name       = "lld";
+    driver->link_func  = &lld_link;
+    driver->in_process = true;
+
+    return driver;
+}
+
+#endif // GSC_LLD_DRIVER
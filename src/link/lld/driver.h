@@ -0,0 +1,21 @@
+//
+// Binary driver which links targets in-process by calling the bundled lld
+// ELF linker through lldcl instead of running an external compiler driver.
+//
+
+#ifndef GEMSTONE_LLD_DRIVER_H
+#define GEMSTONE_LLD_DRIVER_H
+
+#include <link/driver.h>
+
+/**
+ * @brief Link the target in-process with the bundled lld ELF driver.
+ *        Only available when built with GSC_LLD_DRIVER.
+ * @param config link configuration of the target
+ * @return true on success
+ */
+bool lld_link(TargetLinkConfig* config);
+
+BinaryDriver* lld_get_driver();
+
+#endif // GEMSTONE_LLD_DRIVER_H
@@ -3,12 +3,19 @@
 #include <ast/ast.h>
 #include <codegen/backend.h>
 #include <llvm-c/Core.h>
+#include <llvm-c/Target.h>
 #include <llvm-c/TargetMachine.h>
 #include <llvm/backend.h>
 #include <llvm/parser.h>
 #include <mem/cache.h>
 #include <sys/log.h>
 
+// idle target machines created by this process keyed by their
+// configuration, each entry is a list of machines not checked out
+// NULL if the backend is not initialized
+static GHashTable* target_machines = NULL;
+static GMutex target_machine_lock;
+
 Target create_native_target() {
     DEBUG("creating native target...");
     Target target;
@@ -106,11 +113,111 @@ static BackendError llvm_backend_codegen(const Module* unit,
     return parse_module(unit, target);
 }
 
+static char* create_target_machine_key(const Target* target) {
+    return g_strdup_printf("%s %s %s %d %d %d", target->triple.str,
+                           target->cpu.str, target->features.str, target->opt,
+                           target->reloc, target->model);
+}
+
+BackendError get_target_machine(const Target* target,
+                                LLVMTargetMachineRef* machine) {
+    assert(target_machines != NULL);
+
+    g_mutex_lock(&target_machine_lock);
+
+    char* key       = create_target_machine_key(target);
+    GPtrArray* idle = g_hash_table_lookup(target_machines, key);
+
+    // target machines must not emit code on multiple threads at once,
+    // thus a machine is only handed out while it is idle
+    if (idle != NULL && idle->len > 0) {
+        DEBUG("reusing target machine: %s", key);
+        *machine = g_ptr_array_steal_index(idle, idle->len - 1);
+        g_free(key);
+        g_mutex_unlock(&target_machine_lock);
+        return SUCCESS;
+    }
+
+    INFO("Using target (%s): %s with features: %s", target->name.str,
+         target->triple.str, target->features.str);
+
+    LLVMTargetRef llvm_target = NULL;
+    char* error               = NULL;
+
+    DEBUG("creating target...");
+    if (LLVMGetTargetFromTriple(target->triple.str, &llvm_target, &error)
+        != 0) {
+        ERROR("failed to create target machine: %s", error);
+        LLVMDisposeMessage(error);
+        g_free(key);
+        g_mutex_unlock(&target_machine_lock);
+        return new_backend_impl_error(Implementation, NULL,
+                                      "unable to create target machine");
+    }
+    LLVMDisposeMessage(error);
+
+    DEBUG("Creating target machine...");
+    *machine = LLVMCreateTargetMachine(
+      llvm_target, target->triple.str, target->cpu.str, target->features.str,
+      target->opt, target->reloc, target->model);
+
+    g_free(key);
+
+    g_mutex_unlock(&target_machine_lock);
+
+    return SUCCESS;
+}
+
+void release_target_machine(const Target* target,
+                            LLVMTargetMachineRef machine) {
+    assert(target_machines != NULL);
+
+    g_mutex_lock(&target_machine_lock);
+
+    char* key       = create_target_machine_key(target);
+    GPtrArray* idle = g_hash_table_lookup(target_machines, key);
+
+    if (idle == NULL) {
+        idle = g_ptr_array_new_with_free_func(
+          (GDestroyNotify) LLVMDisposeTargetMachine);
+        // ownership of key is passed to the cache
+        g_hash_table_insert(target_machines, key, idle);
+    } else {
+        g_free(key);
+    }
+
+    g_ptr_array_add(idle, machine);
+
+    g_mutex_unlock(&target_machine_lock);
+}
+
 static BackendError llvm_backend_codegen_init(void) {
+    if (target_machines != NULL) {
+        return new_backend_error(Success);
+    }
+
+    // all targets are created for the host, thus only the native target
+    // needs to be registered
+    DEBUG("initializing native target...");
+    if (LLVMInitializeNativeTarget() != 0
+        || LLVMInitializeNativeAsmParser() != 0
+        || LLVMInitializeNativeAsmPrinter() != 0) {
+        return new_backend_impl_error(Implementation, NULL,
+                                      "native target is not available");
+    }
+
+    target_machines = g_hash_table_new_full(
+      g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+
     return new_backend_error(Success);
 }
 
 static BackendError llvm_backend_codegen_deinit(void) {
+    if (target_machines != NULL) {
+        g_hash_table_destroy(target_machines);
+        target_machines = NULL;
+    }
+
     return new_backend_error(Success);
 }
 
@@ -2,6 +2,7 @@
 #ifndef LLVM_CODEGEN_BACKEND_H_
 #define LLVM_CODEGEN_BACKEND_H_
 
+#include <codegen/backend.h>
 #include <llvm-c/TargetMachine.h>
 
 enum StringAllocation_t { LLVM, LIBC, NONE };
@@ -27,6 +28,27 @@ Target create_target_from_config(const TargetConfig* config);
 
 void delete_target(Target target);
 
+/**
+ * @brief Check out a target machine for the given target. Target machines
+ *        are reused per configuration, a new one is only created if all
+ *        machines of the configuration are in use. The machine must be
+ *        returned with release_target_machine().
+ * @param target
+ * @param machine output pointer to the target machine
+ * @return BackendError
+ */
+BackendError get_target_machine(const Target* target,
+                                LLVMTargetMachineRef* machine);
+
+/**
+ * @brief Return a target machine checked out by get_target_machine().
+ *        The backend owns the machine until it is deinitialized.
+ * @param target
+ * @param machine
+ */
+void release_target_machine(const Target* target,
+                            LLVMTargetMachineRef machine);
+
 void llvm_backend_init(void);
 
 #endif // LLVM_CODEGEN_BACKEND_H_
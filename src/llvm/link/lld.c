@@ -2,49 +2,88 @@
 // Created by servostar on 6/4/24.
 //
 
+#include <errno.h>
 #include <link/lib.h>
+#include <llvm-c/Core.h>
 #include <llvm/link/lld.h>
 #include <mem/cache.h>
 #include <sys/col.h>
 #include <sys/log.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 const char* get_absolute_link_path(const TargetConfig* config,
                                    const char* link_target_name) {
     INFO("resolving absolute path for link target: %s", link_target_name);
 
-    for (guint i = 0; i < config->link_search_paths->len; i++) {
-        const char* link_directory_path =
-          g_array_index(config->link_search_paths, char*, i);
-
-        INFO("searching at: %s", link_directory_path);
+    const char* path =
+      find_file_in_directories(config->link_search_paths, link_target_name);
 
-        char* path =
-          g_build_filename(link_directory_path, link_target_name, NULL);
-        char* cwd              = g_get_current_dir();
-        char* canonical        = g_canonicalize_filename(path, cwd);
-        char* cached_canonical = mem_strdup(MemoryNamespaceLld, canonical);
-
-        const gboolean exists = g_file_test(canonical, G_FILE_TEST_EXISTS);
-        const gboolean is_dir = g_file_test(canonical, G_FILE_TEST_IS_DIR);
+    if (path != NULL) {
+        INFO("link target found at: %s", path);
+    }
 
-        g_free(path);
-        g_free(cwd);
-        g_free(canonical);
+    return path;
+}
 
-        if (exists && !is_dir) {
-            INFO("link target found at: %s", cached_canonical);
-            return cached_canonical;
+/**
+ * @brief Copy an object file into an anonymous file in memory which the
+ *        in-process linker can open by path without touching the disk.
+ * @param config link configuration owning the file descriptor
+ * @param name name of the object file
+ * @param object content of the object file
+ * @return path to the object file or NULL on failure
+ */
+static const char* create_memory_object(TargetLinkConfig* config,
+                                        const char* name,
+                                        LLVMMemoryBufferRef object) {
+#ifdef __linux__
+    int fd = memfd_create(name, MFD_CLOEXEC);
+    if (fd < 0) {
+        ERROR("failed to create memory file for object: %s", name);
+        return NULL;
+    }
+    g_array_append_val(config->memory_objects, fd);
+
+    const char* data = LLVMGetBufferStart(object);
+    size_t size      = LLVMGetBufferSize(object);
+
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ERROR("failed to write memory file for object: %s", name);
+            return NULL;
         }
+
+        data += written;
+        size -= written;
     }
 
-    // file not found
+    char* path        = g_strdup_printf("/proc/self/fd/%d", fd);
+    char* cached_path = mem_strdup(MemoryNamespaceLld, path);
+    g_free(path);
+
+    INFO("passing object %s from memory: %s", name, cached_path);
+
+    return cached_path;
+#else
+    ERROR("linking objects from memory is not supported: %s", name);
     return NULL;
+#endif
 }
 
 TargetLinkConfig* lld_create_link_config(__attribute__((unused))
                                          const Target* target,
                                          const TargetConfig* target_config,
-                                         const Module* module) {
+                                         const Module* module,
+                                         const GArray* units,
+                                         const GArray* objects) {
     DEBUG("generating link configuration");
 
     TargetLinkConfig* config =
@@ -53,24 +92,50 @@ TargetLinkConfig* lld_create_link_config(__attribute__((unused))
     config->fatal_warnings = target_config->lld_fatal_warnings;
     config->object_file_names =
       mem_new_g_array(MemoryNamespaceLld, sizeof(char*));
-    config->colorize = stdout_supports_ansi_esc();
-    config->driver   = target_config->driver;
-
-    // append build object file
-    char* basename = g_strjoin(".", target_config->name, "o", NULL);
-    char* filename =
-      g_build_filename(target_config->archive_directory, basename, NULL);
-    g_free(basename);
-    const char* target_object =
-      get_absolute_link_path(target_config, (const char*) filename);
-    if (target_object == NULL) {
-        ERROR("failed to resolve path to target object: %s", filename);
-        g_free(filename);
-        lld_delete_link_config(config);
+    config->memory_objects =
+      mem_new_g_array(MemoryNamespaceLld, sizeof(int));
+    config->colorize           = stdout_supports_ansi_esc();
+    config->driver             = target_config->driver;
+    config->lto                = target_config->lto;
+    config->optimization_level = target_config->optimization_level;
+
+    char* basename = NULL;
+    char* filename = NULL;
+
+    // append build object files
+    for (guint i = 0; i < units->len; i++) {
+        const char* unit = g_array_index(units, const char*, i);
+
+        if (objects != NULL) {
+            const char* memory_object = create_memory_object(
+              config, unit, g_array_index(objects, LLVMMemoryBufferRef, i));
+            if (memory_object == NULL) {
+                lld_delete_link_config(config);
+                return NULL;
+            }
+
+            g_array_append_val(config->object_file_names, memory_object);
+            continue;
+        }
+
+        basename = g_strjoin(".", unit, "o", NULL);
+        filename =
+          g_build_filename(target_config->archive_directory, basename, NULL);
+        g_free(basename);
+
+        const char* target_object =
+          get_absolute_link_path(target_config, (const char*) filename);
+        if (target_object == NULL) {
+            ERROR("failed to resolve path to target object: %s", filename);
+            lld_delete_link_config(config);
+            g_free(filename);
+            return NULL;
+        }
         g_free(filename);
-        return NULL;
+
+        g_array_append_val(config->object_file_names, target_object);
+        INFO("resolved path of target object: %s", target_object);
     }
-    g_free(filename);
 
     {
         // output file after linking
@@ -84,9 +149,6 @@ TargetLinkConfig* lld_create_link_config(__attribute__((unused))
         g_free(filename);
     }
 
-    g_array_append_val(config->object_file_names, target_object);
-    INFO("resolved path of target object: %s", target_object);
-
     // resolve absolute paths to dependent library object files
     DEBUG("resolving target dependencies...");
     for (guint i = 0; i < module->imports->len; i++) {
@@ -102,7 +164,6 @@ TargetLinkConfig* lld_create_link_config(__attribute__((unused))
                           "failed to resolve path to dependency object: %s",
                           dependency);
             lld_delete_link_config(config);
-            lld_delete_link_config(config);
             g_free((void*) library);
             return NULL;
         }
@@ -126,6 +187,13 @@ BackendError lld_link_target(TargetLinkConfig* config) {
 }
 
 void lld_delete_link_config(TargetLinkConfig* config) {
+#ifdef __linux__
+    for (guint i = 0; i < config->memory_objects->len; i++) {
+        close(g_array_index(config->memory_objects, int, i));
+    }
+#endif
+
+    mem_free(config->memory_objects);
     mem_free(config->object_file_names);
     mem_free(config);
 }
@@ -6,12 +6,25 @@
 #define LLVM_BACKEND_LLD_H
 
 #include <codegen/backend.h>
+#include <llvm-c/Types.h>
 #include <llvm/backend.h>
 
+/**
+ * @brief Create the configuration for linking the target.
+ * @param target
+ * @param target_config
+ * @param module
+ * @param units base names of the object files generated for the target
+ * @param objects object files of the units in memory or NULL to link
+ *                the object files written to the archive directory
+ * @return configuration or NULL on failure
+ */
 TargetLinkConfig* lld_create_link_config(__attribute__((unused))
                                          const Target* target,
                                          const TargetConfig* target_config,
-                                         const Module* module);
+                                         const Module* module,
+                                         const GArray* units,
+                                         const GArray* objects);
 
 BackendError lld_link_target(TargetLinkConfig* config);
 
@@ -70,6 +70,80 @@ static LLVMValueRef convert_integral_to_boolean(LLVMBuilderRef builder,
     return LLVMBuildICmp(builder, LLVMIntNE, zero, integral, "to boolean");
 }
 
+/**
+ * @brief Implement a logical and/or. The right operand is only evaluated if
+ *        the left operand does not already decide the result, in which case
+ *        the left operand is the result.
+ * @param unit
+ * @param scope
+ * @param builder
+ * @param operation
+ * @param llvm_result
+ * @return
+ */
+static BackendError impl_short_circuit_operation(LLVMBackendCompileUnit* unit,
+                                                 LLVMLocalScope* scope,
+                                                 LLVMBuilderRef builder,
+                                                 Operation* operation,
+                                                 LLVMValueRef* llvm_result) {
+    Expression* lhs = g_array_index(operation->operands, Expression*, 0);
+    Expression* rhs = g_array_index(operation->operands, Expression*, 1);
+
+    LLVMValueRef llvm_lhs = NULL;
+    BackendError err =
+      impl_expr(unit, scope, builder, lhs, FALSE, 0, &llvm_lhs);
+    if (err.kind != Success) {
+        return err;
+    }
+
+    // the left operand may have split the current block
+    LLVMBasicBlockRef lhs_block = LLVMGetInsertBlock(builder);
+    LLVMBasicBlockRef rhs_block = LLVMAppendBasicBlockInContext(
+      unit->context, scope->func_scope->llvm_func, "logical.rhs");
+    LLVMBasicBlockRef end_block = LLVMAppendBasicBlockInContext(
+      unit->context, scope->func_scope->llvm_func, "logical.end");
+
+    LLVMValueRef zero = LLVMConstNull(LLVMTypeOf(llvm_lhs));
+    LLVMValueRef is_true =
+      LLVMBuildICmp(builder, LLVMIntNE, llvm_lhs, zero, "logical lhs");
+
+    if (operation->impl.logical == LogicalAnd) {
+        LLVMBuildCondBr(builder, is_true, rhs_block, end_block);
+    } else {
+        LLVMBuildCondBr(builder, is_true, end_block, rhs_block);
+    }
+
+    LLVMPositionBuilderAtEnd(builder, rhs_block);
+
+    LLVMValueRef llvm_rhs = NULL;
+    err = impl_expr(unit, scope, builder, rhs, FALSE, 0, &llvm_rhs);
+    if (err.kind != Success) {
+        return err;
+    }
+
+    LLVMValueRef rhs_is_true =
+      LLVMBuildICmp(builder, LLVMIntNE, llvm_rhs, zero, "logical rhs");
+
+    LLVMBasicBlockRef rhs_end_block = LLVMGetInsertBlock(builder);
+    LLVMBuildBr(builder, end_block);
+
+    LLVMPositionBuilderAtEnd(builder, end_block);
+
+    // the result is either 0 or 1 no matter which operand decided it
+    LLVMValueRef values[]      = {is_true, rhs_is_true};
+    LLVMBasicBlockRef blocks[] = {lhs_block, rhs_end_block};
+
+    LLVMValueRef llvm_phi = LLVMBuildPhi(
+      builder, LLVMInt1TypeInContext(unit->context),
+      operation->impl.logical == LogicalAnd ? "logical and" : "logical or");
+    LLVMAddIncoming(llvm_phi, values, blocks, 2);
+
+    *llvm_result =
+      LLVMBuildZExt(builder, llvm_phi, LLVMTypeOf(llvm_lhs), "logical result");
+
+    return SUCCESS;
+}
+
 BackendError impl_logical_operation(LLVMBackendCompileUnit* unit,
                                     LLVMLocalScope* scope,
                                     LLVMBuilderRef builder,
@@ -79,29 +153,35 @@ BackendError impl_logical_operation(LLVMBackendCompileUnit* unit,
     Expression* lhs       = NULL;
     LLVMValueRef llvm_rhs = NULL;
     LLVMValueRef llvm_lhs = NULL;
+    BackendError err      = SUCCESS;
+
+    if (operation->impl.logical == LogicalAnd
+        || operation->impl.logical == LogicalOr) {
+        return impl_short_circuit_operation(unit, scope, builder, operation,
+                                            llvm_result);
+    }
 
     if (operation->impl.logical == LogicalNot) {
         // single operand
         rhs = g_array_index(operation->operands, Expression*, 0);
-        impl_expr(unit, scope, builder, rhs, FALSE, 0, &llvm_rhs);
+        err = impl_expr(unit, scope, builder, rhs, FALSE, 0, &llvm_rhs);
     } else {
-        // two operands
+        // two operands, both are always evaluated
         lhs = g_array_index(operation->operands, Expression*, 0);
-        impl_expr(unit, scope, builder, lhs, FALSE, 0, &llvm_lhs);
+        err = impl_expr(unit, scope, builder, lhs, FALSE, 0, &llvm_lhs);
+        if (err.kind != Success) {
+            return err;
+        }
 
         rhs = g_array_index(operation->operands, Expression*, 1);
-        impl_expr(unit, scope, builder, rhs, FALSE, 0, &llvm_rhs);
+        err = impl_expr(unit, scope, builder, rhs, FALSE, 0, &llvm_rhs);
+    }
+
+    if (err.kind != Success) {
+        return err;
     }
 
     switch (operation->impl.logical) {
-        case LogicalAnd:
-            *llvm_result =
-              LLVMBuildAnd(builder, llvm_lhs, llvm_rhs, "logical and");
-            break;
-        case LogicalOr:
-            *llvm_result =
-              LLVMBuildOr(builder, llvm_lhs, llvm_rhs, "logical or");
-            break;
         case LogicalXor:
             *llvm_result =
               LLVMBuildXor(builder, llvm_lhs, llvm_rhs, "logical xor");
@@ -109,6 +189,8 @@ BackendError impl_logical_operation(LLVMBackendCompileUnit* unit,
         case LogicalNot:
             *llvm_result = LLVMBuildNot(builder, llvm_rhs, "logical not");
             break;
+        default:
+            PANIC("logical operation is short-circuit evaluated");
     }
 
     return SUCCESS;
@@ -9,6 +9,7 @@
 #include <llvm/llvm-ir/variables.h>
 #include <llvm/parser.h>
 #include <mem/cache.h>
+#include <mem/symbol.h>
 #include <set/types.h>
 #include <sys/log.h>
 
@@ -16,7 +17,7 @@ LLVMLocalScope* new_local_scope(LLVMLocalScope* parent) {
     LLVMLocalScope* scope = malloc(sizeof(LLVMLocalScope));
 
     scope->func_scope   = parent->func_scope;
-    scope->vars         = g_hash_table_new(g_str_hash, g_str_equal);
+    scope->vars         = g_hash_table_new(symbol_hash, symbol_equal);
     scope->parent_scope = parent;
 
     return scope;
@@ -68,6 +69,11 @@ LLVMBool is_parameter(const LLVMLocalScope* scope, const char* name) {
     return global_var != NULL;
 }
 
+LLVMValueRef build_local_alloca(const LLVMFuncScope* scope, LLVMTypeRef type,
+                                const char* name) {
+    return LLVMBuildAlloca(scope->alloca_builder, type, name);
+}
+
 BackendError impl_param_type(LLVMBackendCompileUnit* unit,
                              LLVMGlobalScope* scope, Parameter* param,
                              LLVMTypeRef* llvm_type) {
@@ -84,18 +90,14 @@ BackendError impl_param_type(LLVMBackendCompileUnit* unit,
         qualifier     = param->impl.definiton.declaration.qualifier;
     }
 
-    // wrap output variables as pointers
-    if (qualifier == Out || qualifier == InOut) {
-        Type* reference_type = alloca(sizeof(Type));
-
-        reference_type->kind           = TypeKindReference;
-        reference_type->impl.reference = gemstone_type;
+    err = get_type_impl(unit, scope, gemstone_type, llvm_type);
 
-        gemstone_type = reference_type;
+    // wrap output variables as pointers
+    // the wrapped type is built here as types are cached by their address
+    if (err.kind == Success && (qualifier == Out || qualifier == InOut)) {
+        *llvm_type = LLVMPointerType(*llvm_type, 0);
     }
 
-    err = get_type_impl(unit, scope, gemstone_type, llvm_type);
-
     return err;
 }
 
@@ -168,7 +170,7 @@ BackendError impl_func_def(LLVMBackendCompileUnit* unit,
 
         func_scope->llvm_func    = llvm_func;
         func_scope->global_scope = global_scope;
-        func_scope->params       = g_hash_table_new(g_str_hash, g_str_equal);
+        func_scope->params       = g_hash_table_new(symbol_hash, symbol_equal);
 
         // create function body builder
         LLVMBasicBlockRef entry =
@@ -176,6 +178,10 @@ BackendError impl_func_def(LLVMBackendCompileUnit* unit,
         LLVMBuilderRef builder = LLVMCreateBuilderInContext(unit->context);
         LLVMPositionBuilderAtEnd(builder, entry);
 
+        // the entry block only holds stack slots until the body is built
+        func_scope->alloca_builder = LLVMCreateBuilderInContext(unit->context);
+        LLVMPositionBuilderAtEnd(func_scope->alloca_builder, entry);
+
         // create value references for parameter
         for (guint i = 0; i < func->impl.definition.parameter->len; i++) {
             Parameter* param =
@@ -244,6 +250,7 @@ BackendError impl_func_def(LLVMBackendCompileUnit* unit,
 
         // delete function scope GLib structs
         g_hash_table_destroy(func_scope->params);
+        LLVMDisposeBuilder(func_scope->alloca_builder);
     }
 
     return err;
@@ -284,7 +291,8 @@ BackendError impl_functions(LLVMBackendCompileUnit* unit,
     while (g_hash_table_iter_next(&iterator, &key, &val) != FALSE) {
         Function* func = (Function*) val;
 
-        if (func->kind != FunctionDeclarationKind) {
+        if (func->kind != FunctionDeclarationKind
+            && is_defined_in_unit(unit, func->nodePtr)) {
             err = impl_func_def(unit, scope, func, (const char*) key);
         }
 
@@ -352,8 +360,8 @@ BackendError impl_func_call(LLVMBackendCompileUnit* unit,
                 if ((arg->kind == ExpressionKindParameter
                      && !is_parameter_out(arg->impl.parameter))
                     || arg->kind != ExpressionKindParameter) {
-                    LLVMValueRef index =
-                      LLVMConstInt(LLVMInt32Type(), 0, false);
+                    LLVMValueRef index = LLVMConstInt(
+                      LLVMInt32TypeInContext(unit->context), 0, false);
                     LLVMTypeRef llvm_type = NULL;
                     get_type_impl(unit, scope->func_scope->global_scope,
                                   param.impl.declaration.type, &llvm_type);
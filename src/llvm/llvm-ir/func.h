@@ -10,6 +10,9 @@ typedef struct LLVMFuncScope_t {
     // of LLVMTypeRef
     GHashTable* params;
     LLVMValueRef llvm_func;
+    // positioned at the end of the entry block which holds the stack
+    // slots of all local variables
+    LLVMBuilderRef alloca_builder;
 } LLVMFuncScope;
 
 typedef struct LLVMLocalScope_t LLVMLocalScope;
@@ -31,6 +34,18 @@ LLVMValueRef get_parameter(const LLVMFuncScope* scope, const char* name);
 
 LLVMBool is_parameter(const LLVMLocalScope* scope, const char* name);
 
+/**
+ * @brief Create the stack slot of a local variable in the entry block of
+ *        the function. Slots in the entry block are allocated once per call
+ *        regardless of loops and can be promoted to registers.
+ * @param scope
+ * @param type type of the variable
+ * @param name name of the variable
+ * @return the stack slot
+ */
+LLVMValueRef build_local_alloca(const LLVMFuncScope* scope, LLVMTypeRef type,
+                                const char* name);
+
 BackendError impl_function_types(LLVMBackendCompileUnit* unit,
                                  LLVMGlobalScope* scope, GHashTable* variables);
 
@@ -10,6 +10,7 @@
 #include <llvm/llvm-ir/types.h>
 #include <llvm/parser.h>
 #include <mem/cache.h>
+#include <mem/symbol.h>
 #include <sys/log.h>
 
 BackendError impl_param_load(LLVMBackendCompileUnit* unit,
@@ -162,6 +163,12 @@ BackendError impl_basic_block(LLVMBackendCompileUnit* unit,
             return err;
         }
 
+        // statements without blocks of their own may still have moved the
+        // builder, e.g. by short-circuit evaluation of an expression
+        if (llvm_next_end_block == NULL) {
+            end_previous_block = LLVMGetInsertBlock(builder);
+        }
+
         terminated = LLVMGetBasicBlockTerminator(end_previous_block);
         if (llvm_next_end_block != NULL && !terminated) {
             LLVMPositionBuilderAtEnd(builder, end_previous_block);
@@ -205,6 +212,8 @@ BackendError impl_while(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     if (err.kind != Success) {
         return err;
     }
+    // the condition may span multiple blocks
+    LLVMBasicBlockRef while_cond_end_block = LLVMGetInsertBlock(builder);
 
     // build body of loop
     LLVMBasicBlockRef while_start_body_block = NULL;
@@ -223,7 +232,7 @@ BackendError impl_while(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     LLVMBasicBlockRef while_after_block = LLVMAppendBasicBlockInContext(
       unit->context, scope->func_scope->llvm_func, "loop.while.after");
     // build conditional branch at end of condition block
-    LLVMPositionBuilderAtEnd(builder, while_cond_block);
+    LLVMPositionBuilderAtEnd(builder, while_cond_end_block);
     LLVMBuildCondBr(builder, cond_result, while_start_body_block,
                     while_after_block);
 
@@ -238,6 +247,7 @@ BackendError impl_cond_block(LLVMBackendCompileUnit* unit,
                              LLVMBuilderRef builder, LLVMLocalScope* scope,
                              Expression* cond, const Block* block,
                              LLVMBasicBlockRef* cond_block,
+                             LLVMBasicBlockRef* cond_end_block,
                              LLVMBasicBlockRef* start_body_block,
                              LLVMBasicBlockRef* end_body_block,
                              LLVMValueRef* llvm_cond) {
@@ -245,10 +255,14 @@ BackendError impl_cond_block(LLVMBackendCompileUnit* unit,
 
     *cond_block = LLVMAppendBasicBlockInContext(
       unit->context, scope->func_scope->llvm_func, "stmt.branch.cond");
+    *cond_end_block = *cond_block;
     LLVMPositionBuilderAtEnd(builder, *cond_block);
     // Resolve condition in block to a variable
     err = impl_expr(unit, scope, builder, cond, FALSE, 0, llvm_cond);
     if (err.kind == Success) {
+        // the condition may span multiple blocks
+        *cond_end_block = LLVMGetInsertBlock(builder);
+
         // build body of loop
         err = impl_basic_block(unit, builder, scope, block, start_body_block,
                                end_body_block);
@@ -265,6 +279,8 @@ BackendError impl_branch(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     BackendError err = SUCCESS;
 
     GArray* cond_blocks = g_array_new(FALSE, FALSE, sizeof(LLVMBasicBlockRef));
+    GArray* cond_end_blocks =
+      g_array_new(FALSE, FALSE, sizeof(LLVMBasicBlockRef));
     GArray* start_body_blocks =
       g_array_new(FALSE, FALSE, sizeof(LLVMBasicBlockRef));
     GArray* end_body_blocks =
@@ -274,15 +290,18 @@ BackendError impl_branch(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     // add If to arrays
     {
         LLVMBasicBlockRef cond_block       = NULL;
+        LLVMBasicBlockRef cond_end_block   = NULL;
         LLVMBasicBlockRef start_body_block = NULL;
         LLVMBasicBlockRef end_body_block   = NULL;
         LLVMValueRef cond_value            = NULL;
 
         err = impl_cond_block(unit, builder, scope, branch->ifBranch.conditon,
                               &branch->ifBranch.block, &cond_block,
-                              &start_body_block, &end_body_block, &cond_value);
+                              &cond_end_block, &start_body_block,
+                              &end_body_block, &cond_value);
 
         g_array_append_val(cond_blocks, cond_block);
+        g_array_append_val(cond_end_blocks, cond_end_block);
         g_array_append_val(start_body_blocks, start_body_block);
         g_array_append_val(end_body_blocks, end_body_block);
         g_array_append_val(cond_values, cond_value);
@@ -292,17 +311,20 @@ BackendError impl_branch(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     if (branch->elseIfBranches != NULL) {
         for (size_t i = 0; i < branch->elseIfBranches->len; i++) {
             LLVMBasicBlockRef cond_block       = NULL;
+            LLVMBasicBlockRef cond_end_block   = NULL;
             LLVMBasicBlockRef start_body_block = NULL;
             LLVMBasicBlockRef end_body_block   = NULL;
             LLVMValueRef cond_value            = NULL;
 
             ElseIf* elseIf = ((ElseIf*) branch->elseIfBranches->data) + i;
 
-            err = impl_cond_block(
-              unit, builder, scope, elseIf->conditon, &elseIf->block,
-              &cond_block, &start_body_block, &end_body_block, &cond_value);
+            err = impl_cond_block(unit, builder, scope, elseIf->conditon,
+                                  &elseIf->block, &cond_block, &cond_end_block,
+                                  &start_body_block, &end_body_block,
+                                  &cond_value);
 
             g_array_append_val(cond_blocks, cond_block);
+            g_array_append_val(cond_end_blocks, cond_end_block);
             g_array_append_val(start_body_blocks, start_body_block);
             g_array_append_val(end_body_blocks, end_body_block);
             g_array_append_val(cond_values, cond_value);
@@ -334,15 +356,15 @@ BackendError impl_branch(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     for (size_t i = 0; i < cond_blocks->len - 1; i++) {
         LLVMBasicBlockRef next_block =
           g_array_index(cond_blocks, LLVMBasicBlockRef, i + 1);
-        LLVMBasicBlockRef cond_block =
-          g_array_index(cond_blocks, LLVMBasicBlockRef, i);
+        LLVMBasicBlockRef cond_end_block =
+          g_array_index(cond_end_blocks, LLVMBasicBlockRef, i);
         LLVMBasicBlockRef start_body_block =
           g_array_index(start_body_blocks, LLVMBasicBlockRef, i);
         LLVMBasicBlockRef end_body_block =
           g_array_index(end_body_blocks, LLVMBasicBlockRef, i);
         LLVMValueRef cond_value = g_array_index(cond_values, LLVMValueRef, i);
 
-        LLVMPositionBuilderAtEnd(builder, cond_block);
+        LLVMPositionBuilderAtEnd(builder, cond_end_block);
         LLVMBuildCondBr(builder, cond_value, start_body_block, next_block);
 
         LLVMPositionBuilderAtEnd(builder, end_body_block);
@@ -353,6 +375,7 @@ BackendError impl_branch(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     *branch_end_block   = after_block;
 
     g_array_free(cond_blocks, TRUE);
+    g_array_free(cond_end_blocks, TRUE);
     g_array_free(start_body_blocks, TRUE);
     g_array_free(end_body_blocks, TRUE);
     g_array_free(cond_values, TRUE);
@@ -374,7 +397,7 @@ BackendError impl_decl(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     }
 
     DEBUG("creating local variable...");
-    LLVMValueRef local = LLVMBuildAlloca(builder, llvm_type, name);
+    LLVMValueRef local = build_local_alloca(scope->func_scope, llvm_type, name);
 
     LLVMValueRef initial_value = NULL;
     err = get_type_default_value(unit, scope->func_scope->global_scope,
@@ -427,7 +450,7 @@ BackendError impl_def(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
     }
 
     DEBUG("creating local variable...");
-    LLVMValueRef local = LLVMBuildAlloca(builder, llvm_type, name);
+    LLVMValueRef local = build_local_alloca(scope->func_scope, llvm_type, name);
 
     DEBUG("setting default value");
     LLVMBuildStore(builder, initial_value, local);
@@ -506,7 +529,7 @@ BackendError impl_block(LLVMBackendCompileUnit* unit, LLVMBuilderRef builder,
 
     LLVMLocalScope* function_entry_scope = malloc(sizeof(LLVMLocalScope));
     function_entry_scope->func_scope     = scope;
-    function_entry_scope->vars = g_hash_table_new(g_str_hash, g_str_equal);
+    function_entry_scope->vars = g_hash_table_new(symbol_hash, symbol_equal);
     function_entry_scope->parent_scope = NULL;
 
     err = impl_basic_block(unit, builder, function_entry_scope, block,
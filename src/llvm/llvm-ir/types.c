@@ -44,8 +44,8 @@ BackendError impl_reference_const(LLVMBackendCompileUnit* unit,
     BackendError err = SUCCESS;
     if (compareTypes(value->type, (Type*) &StringLiteralType)) {
         // is string literal
-        LLVMValueRef string_value =
-          LLVMConstString(value->value, strlen(value->value), false);
+        LLVMValueRef string_value = LLVMConstStringInContext(
+          unit->context, value->value, strlen(value->value), false);
 
         char uuid[9];
         sprintf(uuid, "%08x", g_str_hash(value->value));
@@ -53,6 +53,8 @@ BackendError impl_reference_const(LLVMBackendCompileUnit* unit,
         LLVMValueRef string_global =
           LLVMAddGlobal(unit->module, LLVMTypeOf(string_value), uuid);
         LLVMSetInitializer(string_global, string_value);
+        // every unit has its own copy of the literal
+        LLVMSetLinkage(string_global, LLVMPrivateLinkage);
         LLVMSetGlobalConstant(string_global, true);
         LLVMSetUnnamedAddress(string_global, LLVMGlobalUnnamedAddr);
         LLVMSetAlignment(string_global, 1);
@@ -213,10 +215,29 @@ BackendError impl_reference_type(LLVMBackendCompileUnit* unit,
                                  LLVMTypeRef* llvm_type);
 
 BackendError impl_box_type(LLVMBackendCompileUnit* unit, LLVMGlobalScope* scope,
-                           BoxType* reference, LLVMTypeRef* llvm_type);
+                           Type* gemstone_type, const char* name,
+                           LLVMTypeRef* llvm_type);
+
+/**
+ * @brief Get the implementation of a type and name boxes which are not
+ *        implemented yet after the given alias.
+ * @param unit
+ * @param scope
+ * @param gemstone_type
+ * @param name name of the struct if the type is a box, NULL for a default
+ * @param llvm_type
+ * @return
+ */
+static BackendError get_named_type_impl(LLVMBackendCompileUnit* unit,
+                                        LLVMGlobalScope* scope,
+                                        Type* gemstone_type, const char* name,
+                                        LLVMTypeRef* llvm_type) {
+    // types are immutable, thus every type is only implemented once per unit
+    *llvm_type = g_hash_table_lookup(scope->type_impls, gemstone_type);
+    if (*llvm_type != NULL) {
+        return SUCCESS;
+    }
 
-BackendError get_type_impl(LLVMBackendCompileUnit* unit, LLVMGlobalScope* scope,
-                           Type* gemstone_type, LLVMTypeRef* llvm_type) {
     DEBUG("retrieving type implementation...");
     BackendError err;
 
@@ -234,26 +255,43 @@ BackendError get_type_impl(LLVMBackendCompileUnit* unit, LLVMGlobalScope* scope,
                                       gemstone_type->impl.reference, llvm_type);
             break;
         case TypeKindBox:
-            err =
-              impl_box_type(unit, scope, gemstone_type->impl.box, llvm_type);
-            break;
+            // caches the struct itself before implementing its members
+            return impl_box_type(unit, scope, gemstone_type, name, llvm_type);
         default:
             PANIC("invalid type kind: %ld", gemstone_type->kind);
     }
 
+    if (err.kind == Success) {
+        g_hash_table_insert(scope->type_impls, gemstone_type, *llvm_type);
+    }
+
     return err;
 }
 
+BackendError get_type_impl(LLVMBackendCompileUnit* unit, LLVMGlobalScope* scope,
+                           Type* gemstone_type, LLVMTypeRef* llvm_type) {
+    return get_named_type_impl(unit, scope, gemstone_type, NULL, llvm_type);
+}
+
 BackendError impl_box_type(LLVMBackendCompileUnit* unit, LLVMGlobalScope* scope,
-                           BoxType* box, LLVMTypeRef* llvm_type) {
+                           Type* gemstone_type, const char* name,
+                           LLVMTypeRef* llvm_type) {
     DEBUG("implementing box type...");
+    BoxType* box = gemstone_type->impl.box;
+
+    // the struct is named and cached before its members are implemented,
+    // this way members may refer to their own box
+    LLVMTypeRef struct_type =
+      LLVMStructCreateNamed(unit->context, name == NULL ? "box" : name);
+    g_hash_table_insert(scope->type_impls, gemstone_type, struct_type);
+
     GHashTableIter iterator;
     g_hash_table_iter_init(&iterator, box->member);
 
     gpointer key = NULL;
     gpointer val = NULL;
 
-    BackendError err;
+    BackendError err = SUCCESS;
 
     GArray* members = g_array_new(FALSE, FALSE, sizeof(LLVMTypeRef));
 
@@ -270,16 +308,17 @@ BackendError impl_box_type(LLVMBackendCompileUnit* unit, LLVMGlobalScope* scope,
             break;
         }
 
-        g_array_append_val(members, llvm_type);
+        g_array_append_val(members, llvm_local_type);
     }
     DEBUG("implemented %ld members", members->len);
 
     if (err.kind == Success) {
-        *llvm_type =
-          LLVMStructType((LLVMTypeRef*) members->data, members->len, 0);
+        LLVMStructSetBody(struct_type, (LLVMTypeRef*) members->data,
+                          members->len, 0);
+        *llvm_type = struct_type;
     }
 
-    g_array_free(members, FALSE);
+    g_array_free(members, TRUE);
 
     return err;
 }
@@ -306,7 +345,7 @@ BackendError impl_type(LLVMBackendCompileUnit* unit, Type* gemstone_type,
     DEBUG("implementing type of kind: %ld as %s", gemstone_type->kind, alias);
 
     LLVMTypeRef llvm_type = NULL;
-    err = get_type_impl(unit, scope, gemstone_type, &llvm_type);
+    err = get_named_type_impl(unit, scope, gemstone_type, alias, &llvm_type);
 
     if (err.kind == Success) {
         g_hash_table_insert(scope->types, (gpointer) alias, llvm_type);
@@ -416,7 +455,7 @@ BackendError get_box_default_value(LLVMBackendCompileUnit* unit,
     gpointer key = NULL;
     gpointer val = NULL;
 
-    BackendError err;
+    BackendError err = SUCCESS;
 
     GArray* constants = g_array_new(FALSE, FALSE, sizeof(LLVMValueRef));
 
@@ -429,14 +468,18 @@ BackendError get_box_default_value(LLVMBackendCompileUnit* unit,
         if (err.kind != Success) {
             break;
         }
+
+        g_array_append_val(constants, constant);
     }
 
     DEBUG("build %ld member default values", constants->len);
 
-    *llvm_value = LLVMConstNamedStruct(
-      llvm_type, (LLVMValueRef*) constants->data, constants->len);
+    if (err.kind == Success) {
+        *llvm_value = LLVMConstNamedStruct(
+          llvm_type, (LLVMValueRef*) constants->data, constants->len);
+    }
 
-    g_array_free(constants, FALSE);
+    g_array_free(constants, TRUE);
 
     return err;
 }
@@ -25,6 +25,12 @@ BackendError impl_global_declaration(LLVMBackendCompileUnit* unit,
     DEBUG("creating global variable...");
     LLVMValueRef global = LLVMAddGlobal(unit->module, llvm_type, name);
 
+    if (!is_defined_in_unit(unit, decl->nodePtr)) {
+        // external declaration, defined by the unit of another module
+        g_hash_table_insert(scope->variables, (gpointer) name, global);
+        return err;
+    }
+
     LLVMValueRef initial_value = NULL;
     err = get_type_default_value(unit, scope, decl->type, &initial_value);
 
@@ -54,6 +60,12 @@ BackendError impl_global_definiton(LLVMBackendCompileUnit* unit,
     DEBUG("creating global variable...");
     LLVMValueRef global = LLVMAddGlobal(unit->module, llvm_type, name);
 
+    if (!is_defined_in_unit(unit, def->nodePtr)) {
+        // external declaration, defined by the unit of another module
+        g_hash_table_insert(scope->variables, (gpointer) name, global);
+        return err;
+    }
+
     // FIXME: resolve initializer expression!
     LLVMValueRef initial_value = NULL;
     err = get_const_type_value(unit, scope, &def->initializer->impl.constant,
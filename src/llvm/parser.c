@@ -1,9 +1,12 @@
 
 #include <codegen/backend.h>
+#include <link/lib.h>
 #include <llvm-c/Analysis.h>
+#include <llvm-c/BitWriter.h>
 #include <llvm-c/Core.h>
 #include <llvm-c/Target.h>
 #include <llvm-c/TargetMachine.h>
+#include <llvm-c/Transforms/PassBuilder.h>
 #include <llvm-c/Types.h>
 #include <llvm/backend.h>
 #include <llvm/link/lld.h>
@@ -11,11 +14,13 @@
 #include <llvm/llvm-ir/types.h>
 #include <llvm/llvm-ir/variables.h>
 #include <llvm/parser.h>
+#include <mem/symbol.h>
 #include <set/types.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/log.h>
+#include <sys/prof.h>
 
 BackendError export_IR(LLVMBackendCompileUnit* unit, const Target* target,
                        const TargetConfig* config) {
@@ -26,7 +31,7 @@ BackendError export_IR(LLVMBackendCompileUnit* unit, const Target* target,
     // convert module to LLVM-IR
     char* ir = LLVMPrintModuleToString(unit->module);
 
-    char* basename = g_strjoin(".", target->name.str, "ll", NULL);
+    char* basename = g_strjoin(".", unit->name, "ll", NULL);
     // construct file name
     const char* filename =
       g_build_filename(config->archive_directory, basename, NULL);
@@ -72,12 +77,12 @@ BackendError emit_module_to_file(LLVMBackendCompileUnit* unit,
     const char* filename;
     switch (file_type) {
         case LLVMAssemblyFile:
-            basename = g_strjoin(".", config->name, "s", NULL);
+            basename = g_strjoin(".", unit->name, "s", NULL);
             filename =
               g_build_filename(config->archive_directory, basename, NULL);
             break;
         case LLVMObjectFile:
-            basename = g_strjoin(".", config->name, "o", NULL);
+            basename = g_strjoin(".", unit->name, "o", NULL);
             filename =
               g_build_filename(config->archive_directory, basename, NULL);
             break;
@@ -105,38 +110,113 @@ BackendError emit_module_to_file(LLVMBackendCompileUnit* unit,
     return err;
 }
 
-BackendError export_object(LLVMBackendCompileUnit* unit, const Target* target,
-                           const TargetConfig* config) {
+BackendError emit_module_to_bitcode(LLVMBackendCompileUnit* unit,
+                                    const TargetConfig* config) {
     BackendError err = SUCCESS;
-    DEBUG("exporting object file...");
-
-    INFO("Using target (%s): %s with features: %s", target->name.str,
-         target->triple.str, target->features.str);
+    DEBUG("Generating bitcode...");
 
-    LLVMTargetRef llvm_target = NULL;
-    char* error               = NULL;
+    // linkers detect bitcode by its magic number regardless of extension
+    char* basename = g_strjoin(".", unit->name, "o", NULL);
+    char* filename =
+      g_build_filename(config->archive_directory, basename, NULL);
 
-    LLVMInitializeAllTargets();
-    LLVMInitializeAllTargetInfos();
-    LLVMInitializeAllTargetMCs();
-    // NOTE: for code generation (assmebly or binary) we need the following:
-    LLVMInitializeAllAsmParsers();
-    LLVMInitializeAllAsmPrinters();
+    INFO("export to file: %s", filename);
 
-    DEBUG("creating target...");
-    if (LLVMGetTargetFromTriple(target->triple.str, &llvm_target, &error)
-        != 0) {
-        ERROR("failed to create target machine: %s", error);
+    if (LLVMWriteBitcodeToFile(unit->module, filename) != 0) {
+        ERROR("failed to write bitcode: %s", filename);
         err = new_backend_impl_error(Implementation, NULL,
-                                     "unable to create target machine");
+                                     "failed to write bitcode");
+    } else {
+        print_message(Info, "Generated bitcode was written to: %s", filename);
+    }
+
+    g_free(filename);
+    g_free(basename);
+    return err;
+}
+
+BackendError emit_module_to_memory(LLVMBackendCompileUnit* unit,
+                                   LLVMTargetMachineRef target_machine,
+                                   const TargetConfig* config) {
+    BackendError err = SUCCESS;
+    DEBUG("Generating object in memory...");
+
+    if (config->lto != LTOModeNone) {
+        unit->object = LLVMWriteBitcodeToMemoryBuffer(unit->module);
         return err;
     }
+
+    char* error = NULL;
+    if (LLVMTargetMachineEmitToMemoryBuffer(target_machine, unit->module,
+                                            LLVMObjectFile, &error,
+                                            &unit->object)
+        != 0) {
+        ERROR("failed to emit code: %s", error);
+        err =
+          new_backend_impl_error(Implementation, NULL, "failed to emit code");
+        unit->object = NULL;
+    }
     LLVMDisposeMessage(error);
 
-    DEBUG("Creating target machine...");
-    LLVMTargetMachineRef target_machine = LLVMCreateTargetMachine(
-      llvm_target, target->triple.str, target->cpu.str, target->features.str,
-      target->opt, target->reloc, target->model);
+    return err;
+}
+
+static const char* get_pass_pipeline(const TargetConfig* config) {
+    if (config->opt_pipeline != NULL) {
+        return config->opt_pipeline;
+    }
+
+    // with link time optimization modules are only prepared here,
+    // the remaining passes run when linking
+    static const char* pipelines[][3] = {
+      [LTOModeNone] = {"default<O1>", "default<O2>", "default<O3>"},
+      [LTOModeThin] = {"thinlto-pre-link<O1>", "thinlto-pre-link<O2>",
+                       "thinlto-pre-link<O3>"},
+      [LTOModeFull] = {"lto-pre-link<O1>", "lto-pre-link<O2>",
+                       "lto-pre-link<O3>"}};
+
+    if (config->optimization_level < 1 || config->optimization_level > 3) {
+        PANIC("invalid optimization level: %d", config->optimization_level);
+    }
+
+    return pipelines[config->lto][config->optimization_level - 1];
+}
+
+BackendError optimize_module(LLVMBackendCompileUnit* unit,
+                             LLVMTargetMachineRef target_machine,
+                             const TargetConfig* config) {
+    BackendError err = SUCCESS;
+
+    const char* pipeline = get_pass_pipeline(config);
+    INFO("running pass pipeline: %s", pipeline);
+
+    LLVMPassBuilderOptionsRef options = LLVMCreatePassBuilderOptions();
+    LLVMPassBuilderOptionsSetVerifyEach(options, FALSE);
+
+    LLVMErrorRef error =
+      LLVMRunPasses(unit->module, pipeline, target_machine, options);
+    if (error != NULL) {
+        char* message = LLVMGetErrorMessage(error);
+        print_message(Error, "Invalid pass pipeline `%s`: %s", pipeline,
+                      message);
+        LLVMDisposeErrorMessage(message);
+
+        err = new_backend_impl_error(Implementation, NULL,
+                                     "failed to run pass pipeline");
+    }
+
+    LLVMDisposePassBuilderOptions(options);
+
+    return err;
+}
+
+BackendError export_object(LLVMBackendCompileUnit* unit,
+                           LLVMTargetMachineRef target_machine,
+                           const Target* target, const TargetConfig* config) {
+    BackendError err = SUCCESS;
+    DEBUG("exporting object file...");
+
+    char* error = NULL;
 
     print_message(Info, "Generating code for: %s", target->triple.str);
 
@@ -149,10 +229,14 @@ BackendError export_object(LLVMBackendCompileUnit* unit, const Target* target,
         return err;
     }
 
-    err =
-      emit_module_to_file(unit, target_machine, LLVMObjectFile, error, config);
-
-    LLVMDisposeTargetMachine(target_machine);
+    if (link_objects_in_memory(config)) {
+        err = emit_module_to_memory(unit, target_machine, config);
+    } else if (config->lto != LTOModeNone) {
+        err = emit_module_to_bitcode(unit, config);
+    } else {
+        err = emit_module_to_file(unit, target_machine, LLVMObjectFile, error,
+                                  config);
+    }
 
     return err;
 }
@@ -183,9 +267,25 @@ BackendError export_module(LLVMBackendCompileUnit* unit, const Target* target,
                            const TargetConfig* config) {
     DEBUG("exporting module...");
 
-    BackendError err = SUCCESS;
+    LLVMTargetMachineRef target_machine = NULL;
+    BackendError err = get_target_machine(target, &target_machine);
+    if (err.kind != Success) {
+        return err;
+    }
+
+    // run mid-level IR passes before emission so that both the printed
+    // IR and the generated code reflect the optimized module
+    ProfilePhase phase = prof_begin("optimize", unit->name);
+    err                = optimize_module(unit, target_machine, config);
+    prof_end(&phase);
+
+    if (err.kind == Success) {
+        phase = prof_begin("emit", unit->name);
+        err   = export_object(unit, target_machine, target, config);
+        prof_end(&phase);
+    }
 
-    export_object(unit, target, config);
+    release_target_machine(target, target_machine);
 
     if (config->print_ir) {
         export_IR(unit, target, config);
@@ -200,33 +300,45 @@ static BackendError build_module(LLVMBackendCompileUnit* unit,
     DEBUG("building module...");
     BackendError err = SUCCESS;
 
-    err = impl_types(unit, global_scope, module->types);
+    ProfilePhase phase = prof_begin("codegen types", unit->name);
+    err                = impl_types(unit, global_scope, module->types);
+    prof_end(&phase);
     if (err.kind != Success) {
         return err;
     }
 
     // NOTE: functions of boxes are not stored in the box itself,
     //       thus for a box we only implement the type
-    err = impl_types(unit, global_scope, module->boxes);
+    phase = prof_begin("codegen boxes", unit->name);
+    err   = impl_types(unit, global_scope, module->boxes);
+    prof_end(&phase);
     if (err.kind != Success) {
         return err;
     }
 
-    err = impl_global_variables(unit, global_scope, module->variables);
+    phase = prof_begin("codegen globals", unit->name);
+    err   = impl_global_variables(unit, global_scope, module->variables);
+    prof_end(&phase);
     if (err.kind != Success) {
         return err;
     }
 
-    err = impl_function_types(unit, global_scope, module->functions);
+    phase = prof_begin("codegen function types", unit->name);
+    err   = impl_function_types(unit, global_scope, module->functions);
+    prof_end(&phase);
     if (err.kind != Success) {
         return err;
     }
 
-    err = impl_functions(unit, global_scope, module->functions);
+    phase = prof_begin("codegen functions", unit->name);
+    err   = impl_functions(unit, global_scope, module->functions);
+    prof_end(&phase);
     if (err.kind != Success) {
         return err;
     }
 
+    phase = prof_begin("verify", unit->name);
+
     char* error = NULL;
     if (LLVMVerifyModule(unit->module, LLVMReturnStatusAction, &error)) {
         print_message(Error, "Unable to compile due to: %s", error);
@@ -235,23 +347,132 @@ static BackendError build_module(LLVMBackendCompileUnit* unit,
     }
     LLVMDisposeMessage(error);
 
+    prof_end(&phase);
+
     return err;
 }
 
-BackendError parse_module(const Module* module, const TargetConfig* config) {
-    DEBUG("generating code for module %p", module);
-    if (module == NULL) {
-        ERROR("no module for codegen");
-        return new_backend_impl_error(Implementation, NULL, "no module");
+bool is_defined_in_unit(const LLVMBackendCompileUnit* unit,
+                        AST_NODE_PTR node) {
+    if (unit->partitions == NULL) {
+        return TRUE;
+    }
+
+    gpointer key = node->location.file;
+    if (unit->sharded) {
+        key = node;
+    }
+
+    guint partition =
+      GPOINTER_TO_UINT(g_hash_table_lookup(unit->partitions, key));
+
+    return partition == unit->partition;
+}
+
+static void add_partition(GHashTable* partitions, const TargetConfig* config,
+                          AST_NODE_PTR node) {
+    ModuleFile* file = node->location.file;
+
+    // the root module is always defined by the first unit
+    if (file == NULL || strcmp(file->path, config->root_module) == 0
+        || g_hash_table_contains(partitions, file)) {
+        return;
     }
 
-    LLVMBackendCompileUnit* unit = malloc(sizeof(LLVMBackendCompileUnit));
+    guint partition = g_hash_table_size(partitions) + 1;
+    g_hash_table_insert(partitions, file, GUINT_TO_POINTER(partition));
+}
+
+/**
+ * @brief Assign every module file which defines a function or variable
+ *        its own unit.
+ * @param module
+ * @param config
+ * @return map of module files to the index of their unit
+ */
+static GHashTable* create_partitions(const Module* module,
+                                     const TargetConfig* config) {
+    GHashTable* partitions = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    GHashTableIter iterator;
+    gpointer key = NULL;
+    gpointer val = NULL;
+
+    g_hash_table_iter_init(&iterator, module->variables);
+    while (g_hash_table_iter_next(&iterator, &key, &val) != FALSE) {
+        add_partition(partitions, config, ((Variable*) val)->nodePtr);
+    }
 
+    g_hash_table_iter_init(&iterator, module->functions);
+    while (g_hash_table_iter_next(&iterator, &key, &val) != FALSE) {
+        const Function* func = val;
+
+        if (func->kind == FunctionDefinitionKind) {
+            add_partition(partitions, config, func->nodePtr);
+        }
+    }
+
+    return partitions;
+}
+
+static gint compare_function_names(gconstpointer a, gconstpointer b) {
+    const Function* func_a = *(const Function**) a;
+    const Function* func_b = *(const Function**) b;
+
+    return strcmp(func_a->name, func_b->name);
+}
+
+/**
+ * @brief Distribute all function definitions round robin over the shards.
+ *        Functions are ordered by name so that every build assigns them
+ *        the same shard regardless of the order they were parsed in.
+ * @param module
+ * @param shard_count requested number of shards
+ * @param unit_count output for the number of units actually used
+ * @return map of function definition nodes to the index of their unit
+ */
+static GHashTable* create_shards(const Module* module, guint shard_count,
+                                 guint* unit_count) {
+    GHashTable* partitions = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GPtrArray* definitions = g_ptr_array_new();
+
+    GHashTableIter iterator;
+    gpointer key = NULL;
+    gpointer val = NULL;
+
+    g_hash_table_iter_init(&iterator, module->functions);
+    while (g_hash_table_iter_next(&iterator, &key, &val) != FALSE) {
+        Function* func = val;
+
+        if (func->kind == FunctionDefinitionKind) {
+            g_ptr_array_add(definitions, func);
+        }
+    }
+
+    g_ptr_array_sort(definitions, compare_function_names);
+
+    // avoid units without any function
+    *unit_count = MAX(1, MIN(shard_count, definitions->len));
+
+    for (guint i = 0; i < definitions->len; i++) {
+        const Function* func = g_ptr_array_index(definitions, i);
+        g_hash_table_insert(partitions, func->nodePtr,
+                            GUINT_TO_POINTER(i % *unit_count));
+    }
+
+    g_ptr_array_free(definitions, TRUE);
+
+    return partitions;
+}
+
+static BackendError compile_unit(LLVMBackendCompileUnit* unit,
+                                 const Module* module, const Target* target,
+                                 const TargetConfig* config) {
     // we start with a LLVM module
     DEBUG("creating LLVM context and module");
     unit->context = LLVMContextCreate();
     unit->module =
-      LLVMModuleCreateWithNameInContext(config->root_module, unit->context);
+      LLVMModuleCreateWithNameInContext(unit->name, unit->context);
 
     LLVMGlobalScope* global_scope = new_global_scope(module);
 
@@ -260,26 +481,8 @@ BackendError parse_module(const Module* module, const TargetConfig* config) {
     BackendError err = build_module(unit, global_scope, module);
     if (err.kind == Success) {
         INFO("Module build successfully...");
-        Target target = create_target_from_config(config);
-
-        err = export_module(unit, &target, config);
-        if (err.kind == Success) {
-            if (config->mode == Application) {
-                TargetLinkConfig* link_config =
-                  lld_create_link_config(&target, config, module);
-
-                if (link_config != NULL) {
-                    err = lld_link_target(link_config);
-
-                    lld_delete_link_config(link_config);
-                } else {
-                    err = new_backend_impl_error(Implementation, NULL,
-                                                 "libclang error");
-                }
-            }
-        }
 
-        delete_target(target);
+        err = export_module(unit, target, config);
     }
 
     delete_global_scope(global_scope);
@@ -287,7 +490,179 @@ BackendError parse_module(const Module* module, const TargetConfig* config) {
     LLVMDisposeModule(unit->module);
     LLVMContextDispose(unit->context);
 
-    free(unit);
+    return err;
+}
+
+/**
+ * @brief A unit compiled on a thread of its own.
+ */
+typedef struct CodegenJob_t {
+    LLVMBackendCompileUnit unit;
+    const Module* module;
+    const Target* target;
+    const TargetConfig* config;
+    BackendError err;
+} CodegenJob;
+
+static void run_codegen_job(gpointer data,
+                            [[maybe_unused]] gpointer user_data) {
+    CodegenJob* job = data;
+
+    job->err = compile_unit(&job->unit, job->module, job->target, job->config);
+}
+
+/**
+ * @brief Compile all units. Every unit has its own LLVM context, thus
+ *        shards are compiled concurrently on a thread pool.
+ * @param jobs
+ * @param parallel
+ */
+static void run_codegen_jobs(GArray* jobs, bool parallel) {
+    if (!parallel || jobs->len == 1) {
+        for (guint i = 0; i < jobs->len; i++) {
+            CodegenJob* job = &g_array_index(jobs, CodegenJob, i);
+            run_codegen_job(job, NULL);
+
+            if (job->err.kind != Success) {
+                break;
+            }
+        }
+        return;
+    }
+
+    GThreadPool* pool = g_thread_pool_new(
+      run_codegen_job, NULL, (gint) g_get_num_processors(), FALSE, NULL);
+
+    for (guint i = 0; i < jobs->len; i++) {
+        g_thread_pool_push(pool, &g_array_index(jobs, CodegenJob, i), NULL);
+    }
+
+    // wait for all units to be compiled
+    g_thread_pool_free(pool, FALSE, TRUE);
+}
+
+BackendError parse_module(const Module* module, const TargetConfig* config) {
+    DEBUG("generating code for module %p", module);
+    if (module == NULL) {
+        ERROR("no module for codegen");
+        return new_backend_impl_error(Implementation, NULL, "no module");
+    }
+
+    GHashTable* partitions = NULL;
+    guint unit_count       = 1;
+    bool sharded           = false;
+
+    if (config->codegen_shards > 1) {
+        if (config->mode == Application) {
+            const guint shards = (guint) config->codegen_shards;
+
+            partitions = create_shards(module, shards, &unit_count);
+            sharded    = true;
+
+            if (config->separate_compilation) {
+                print_message(Warning, "Separate compilation is ignored "
+                                       "for sharded code generation");
+            }
+        } else {
+            print_message(Warning, "Sharded code generation is only "
+                                   "supported for applications");
+        }
+    }
+
+    if (config->separate_compilation && !sharded) {
+        if (config->mode == Application) {
+            partitions = create_partitions(module, config);
+            unit_count += g_hash_table_size(partitions);
+        } else {
+            print_message(Warning, "Separate compilation is only supported "
+                                   "for applications");
+        }
+    }
+
+    // base names of the object files to link
+    GArray* units = mem_new_g_array(MemoryNamespaceLlvm, sizeof(char*));
+    // object files kept in memory if the linker does not need the archive
+    GArray* objects = NULL;
+    if (link_objects_in_memory(config)) {
+        objects =
+          mem_new_g_array(MemoryNamespaceLlvm, sizeof(LLVMMemoryBufferRef));
+    }
+
+    Target target = create_target_from_config(config);
+
+    GArray* jobs = mem_new_g_array(MemoryNamespaceLlvm, sizeof(CodegenJob));
+    for (guint i = 0; i < unit_count; i++) {
+        CodegenJob job;
+        job.unit.partitions = partitions;
+        job.unit.sharded    = sharded;
+        job.unit.partition  = i;
+        job.unit.object     = NULL;
+        job.module          = module;
+        job.target          = &target;
+        job.config          = config;
+        job.err             = SUCCESS;
+
+        if (i == 0) {
+            job.unit.name = mem_strdup(MemoryNamespaceLlvm, config->name);
+        } else {
+            char* name    = g_strdup_printf("%s.%u", config->name, i);
+            job.unit.name = mem_strdup(MemoryNamespaceLlvm, name);
+            g_free(name);
+        }
+
+        g_array_append_val(jobs, job);
+    }
+
+    run_codegen_jobs(jobs, sharded);
+
+    // collect the results in order of the units so that the linked
+    // binary does not depend on which shard finished first
+    BackendError err = SUCCESS;
+    for (guint i = 0; i < jobs->len; i++) {
+        const CodegenJob* job = &g_array_index(jobs, CodegenJob, i);
+
+        if (err.kind == Success) {
+            err = job->err;
+        }
+
+        g_array_append_val(units, job->unit.name);
+
+        if (objects != NULL && job->unit.object != NULL) {
+            g_array_append_val(objects, job->unit.object);
+        }
+    }
+    mem_free(jobs);
+
+    if (err.kind == Success && config->mode == Application) {
+        TargetLinkConfig* link_config =
+          lld_create_link_config(&target, config, module, units, objects);
+
+        if (link_config != NULL) {
+            ProfilePhase phase = prof_begin("link", config->name);
+            err                = lld_link_target(link_config);
+            prof_end(&phase);
+
+            lld_delete_link_config(link_config);
+        } else {
+            err = new_backend_impl_error(Implementation, NULL,
+                                         "libclang error");
+        }
+    }
+
+    delete_target(target);
+
+    if (partitions != NULL) {
+        g_hash_table_destroy(partitions);
+    }
+    mem_free(units);
+
+    if (objects != NULL) {
+        for (guint i = 0; i < objects->len; i++) {
+            LLVMDisposeMemoryBuffer(
+              g_array_index(objects, LLVMMemoryBufferRef, i));
+        }
+        mem_free(objects);
+    }
 
     return err;
 }
@@ -296,10 +671,11 @@ LLVMGlobalScope* new_global_scope(const Module* module) {
     DEBUG("creating global scope...");
     LLVMGlobalScope* scope = malloc(sizeof(LLVMGlobalScope));
 
-    scope->module    = (Module*) module;
-    scope->functions = g_hash_table_new(g_str_hash, g_str_equal);
-    scope->variables = g_hash_table_new(g_str_hash, g_str_equal);
-    scope->types     = g_hash_table_new(g_str_hash, g_str_equal);
+    scope->module     = (Module*) module;
+    scope->functions  = g_hash_table_new(symbol_hash, symbol_equal);
+    scope->variables  = g_hash_table_new(symbol_hash, symbol_equal);
+    scope->types      = g_hash_table_new(symbol_hash, symbol_equal);
+    scope->type_impls = g_hash_table_new(g_direct_hash, g_direct_equal);
 
     return scope;
 }
@@ -308,6 +684,7 @@ void delete_global_scope(LLVMGlobalScope* scope) {
     DEBUG("deleting global scope...");
     g_hash_table_unref(scope->functions);
     g_hash_table_unref(scope->types);
+    g_hash_table_unref(scope->type_impls);
     g_hash_table_unref(scope->variables);
     free(scope);
 }
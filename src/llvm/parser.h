@@ -10,10 +10,25 @@
 typedef struct LLVMBackendCompileUnit_t {
     LLVMContextRef context;
     LLVMModuleRef module;
+    // base name of all files emitted for this unit
+    const char* name;
+    // maps module files to the index of the unit which defines their
+    // functions and variables. Files not contained belong to unit 0.
+    // NULL if this unit defines everything.
+    GHashTable* partitions;
+    // if set partitions maps the nodes of function definitions instead of
+    // module files. Variables are always defined by unit 0.
+    bool sharded;
+    // index of this unit
+    guint partition;
+    // object file of this unit if it is linked from memory
+    LLVMMemoryBufferRef object;
 } LLVMBackendCompileUnit;
 
 typedef struct LLVMGlobalScope_t {
     GHashTable* types;
+    // maps types (Type*) to their implementation (LLVMTypeRef)
+    GHashTable* type_impls;
     // of type LLVMValueRef
     GHashTable* variables;
     // of type LLVMTypeRef
@@ -24,6 +39,17 @@ typedef struct LLVMGlobalScope_t {
 
 LLVMGlobalScope* new_global_scope(const Module* module);
 
+/**
+ * @brief Check whether the function or variable of the given node is defined
+ *        by the unit. Everything else is only declared and resolved by the
+ *        linker.
+ * @param unit
+ * @param node
+ * @return
+ */
+bool is_defined_in_unit(const LLVMBackendCompileUnit* unit,
+                        AST_NODE_PTR node);
+
 void list_available_targets();
 
 void delete_global_scope(LLVMGlobalScope* scope);
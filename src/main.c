@@ -1,10 +1,10 @@
 #include <ast/ast.h>
 #include <cfg/opt.h>
 #include <compiler.h>
-#include <lex/util.h>
 #include <link/lib.h>
 #include <llvm/parser.h>
 #include <mem/cache.h>
+#include <server/server.h>
 #include <stdlib.h>
 #include <sys/col.h>
 #include <sys/log.h>
@@ -39,8 +39,6 @@ void setup(int argc, char* argv[]) {
 
     col_init();
 
-    lex_init();
-
     link_init();
 
     init_toml();
@@ -76,6 +74,19 @@ int main(int argc, char* argv[]) {
         exit(0);
     }
 
+    if (is_option_set("server")) {
+        return run_server();
+    }
+
+    if (is_option_set("client")) {
+        int status = EXIT_FAILURE;
+
+        if (run_client(argc, argv, &status)) {
+            return status;
+        }
+        // no server running, compile within this process
+    }
+
     int status = run_compiler();
 
     if (is_option_set("print-gc-stats")) {
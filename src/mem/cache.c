@@ -6,11 +6,22 @@
 #include <cfg/opt.h>
 #include <glib.h>
 #include <mem/cache.h>
+#include <stddef.h>
 #include <string.h>
 #include <sys/log.h>
 
 static GHashTable* namespaces = NULL;
 
+// maps every individually freed block to its namespace
+static GHashTable* block_index = NULL;
+
+// guards the namespaces, the block index and the states of arena threads
+static GMutex cache_lock;
+
+// allocations of all namespaces since startup, except those made from
+// arenas which are counted per thread
+static size_t total_allocation_count = 0;
+
 typedef struct MemoryNamespaceStatistic_t {
     size_t bytes_allocated;
     size_t allocation_count;
@@ -32,13 +43,68 @@ typedef struct MemoryBlock_t {
     MemoryBlockType kind;
 } MemoryBlock;
 
+// default capacity of a single arena slab
+#define ARENA_SLAB_SIZE (64 * 1024)
+// allocations bigger than this get a dedicated slab
+#define ARENA_LARGE_BLOCK_SIZE (ARENA_SLAB_SIZE / 4)
+#define ARENA_ALIGNMENT        _Alignof(max_align_t)
+// every arena block is preceded by its size for reallocation
+#define ARENA_HEADER_SIZE ARENA_ALIGNMENT
+
+#define ARENA_ALIGN(size) \
+    (((size) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+typedef struct ArenaSlab_t {
+    struct ArenaSlab_t* next;
+    size_t capacity;
+    size_t used;
+    max_align_t data[];
+} ArenaSlab;
+
 typedef struct MemoryNamespace_t {
     MemoryNamespaceStatistic statistic;
-    GArray* blocks;
+    // blocks which are freed individually mapped to their MemoryBlockType
+    GHashTable* blocks;
+    // index into arena_namespaces or -1 if generic blocks are not
+    // allocated from an arena
+    int arena_index;
+    // all slabs of the arena of every thread
+    ArenaSlab* slabs;
 } MemoryNamespace;
 
 typedef MemoryNamespace* MemoryNamespaceRef;
 
+// namespaces which are only ever purged as a whole and use an arena
+static const char* arena_namespaces[] = {
+  MemoryNamespaceAst, MemoryNamespaceLex, MemoryNamespaceSet,
+  MemoryNamespaceSymbol};
+
+#define ARENA_NAMESPACE_COUNT (sizeof(arena_namespaces) / sizeof(char*))
+
+/**
+ * @brief Allocation state of a single thread in all arena namespaces.
+ *        Threads bump generic blocks from their own slab without taking
+ *        the cache lock. Only new slabs are linked into their namespace
+ *        under the lock, so that purging releases the slabs of all threads.
+ */
+typedef struct ArenaThread_t {
+    // slab the thread currently allocates from per arena namespace
+    ArenaSlab* slabs[ARENA_NAMESPACE_COUNT];
+    // allocations made by the thread per arena namespace
+    MemoryNamespaceStatistic statistics[ARENA_NAMESPACE_COUNT];
+    // blocks allocated since the last purge per arena namespace
+    size_t block_counts[ARENA_NAMESPACE_COUNT];
+    // false once the owning thread exited, the state is then reused
+    bool in_use;
+} ArenaThread;
+
+// states of every thread that ever allocated from an arena namespace
+static GPtrArray* arena_threads = NULL;
+
+static void release_arena_thread(gpointer data);
+
+static GPrivate current_arena_thread = G_PRIVATE_INIT(release_arena_thread);
+
 static void
   namespace_statistics_print(MemoryNamespaceStatistic* memoryNamespaceStatistic,
                              char* name) {
@@ -61,21 +127,255 @@ static void
     printf("\n");
 }
 
+static ArenaSlab* arena_new_slab(size_t capacity) {
+    ArenaSlab* slab = malloc(sizeof(ArenaSlab) + capacity);
+
+    if (slab != NULL) {
+        slab->next     = NULL;
+        slab->capacity = capacity;
+        slab->used     = 0;
+    }
+
+    return slab;
+}
+
+static MemoryNamespaceRef check_namespace(MemoryNamespaceName name);
+
+static ArenaThread* get_arena_thread(void) {
+    ArenaThread* thread = g_private_get(&current_arena_thread);
+
+    if (thread != NULL) {
+        return thread;
+    }
+
+    g_mutex_lock(&cache_lock);
+
+    if (arena_threads == NULL) {
+        arena_threads = g_ptr_array_new();
+    }
+
+    for (guint i = 0; i < arena_threads->len && thread == NULL; i++) {
+        ArenaThread* other = g_ptr_array_index(arena_threads, i);
+
+        if (!other->in_use) {
+            thread = other;
+        }
+    }
+
+    if (thread == NULL) {
+        thread = calloc(1, sizeof(ArenaThread));
+
+        if (thread == NULL) {
+            PANIC("failed to allocate arena state of thread");
+        }
+
+        g_ptr_array_add(arena_threads, thread);
+    }
+
+    thread->in_use = true;
+
+    g_mutex_unlock(&cache_lock);
+
+    g_private_set(&current_arena_thread, thread);
+
+    return thread;
+}
+
+static void release_arena_thread(gpointer data) {
+    ArenaThread* thread = data;
+
+    g_mutex_lock(&cache_lock);
+
+    // slabs are owned by their namespace and statistics are kept
+    // for reporting
+    memset(thread->slabs, 0, sizeof(thread->slabs));
+    thread->in_use = false;
+
+    g_mutex_unlock(&cache_lock);
+}
+
+static ArenaSlab* arena_add_slab(size_t arena_index, size_t capacity) {
+    ArenaSlab* slab = arena_new_slab(capacity);
+
+    if (slab != NULL) {
+        g_mutex_lock(&cache_lock);
+
+        MemoryNamespaceRef memoryNamespace =
+          check_namespace((MemoryNamespaceName) arena_namespaces[arena_index]);
+
+        slab->next             = memoryNamespace->slabs;
+        memoryNamespace->slabs = slab;
+
+        g_mutex_unlock(&cache_lock);
+    }
+
+    return slab;
+}
+
+static void* arena_malloc(ArenaThread* thread, size_t arena_index,
+                          size_t size) {
+    const size_t needed = ARENA_HEADER_SIZE + ARENA_ALIGN(size);
+    ArenaSlab* slab     = thread->slabs[arena_index];
+
+    if (needed > ARENA_LARGE_BLOCK_SIZE) {
+        // dedicated slab, keep bumping in the current one
+        slab = arena_add_slab(arena_index, needed);
+
+    } else if (slab == NULL || slab->capacity - slab->used < needed) {
+        slab = arena_add_slab(arena_index, ARENA_SLAB_SIZE);
+
+        thread->slabs[arena_index] = slab;
+    }
+
+    if (slab == NULL) {
+        return NULL;
+    }
+
+    char* header = (char*) slab->data + slab->used;
+    slab->used += needed;
+
+    *(size_t*) header = size;
+    thread->block_counts[arena_index]++;
+
+    return header + ARENA_HEADER_SIZE;
+}
+
+static void* arena_realloc(ArenaThread* thread, size_t arena_index,
+                           void* block, size_t size) {
+    char* header          = (char*) block - ARENA_HEADER_SIZE;
+    const size_t old_size = *(size_t*) header;
+    ArenaSlab* slab       = thread->slabs[arena_index];
+
+    // the most recent block of the current slab can grow in place
+    if (slab != NULL
+        && (char*) block + ARENA_ALIGN(old_size)
+             == (char*) slab->data + slab->used
+        && slab->capacity - slab->used + ARENA_ALIGN(old_size)
+             >= ARENA_ALIGN(size)) {
+        slab->used = slab->used - ARENA_ALIGN(old_size) + ARENA_ALIGN(size);
+        *(size_t*) header = size;
+        return block;
+    }
+
+    void* reallocated_block = arena_malloc(thread, arena_index, size);
+    if (reallocated_block != NULL) {
+        memcpy(reallocated_block, block, MIN(old_size, size));
+    }
+
+    return reallocated_block;
+}
+
+static void* arena_alloc(size_t arena_index, size_t size) {
+    assert(size != 0);
+
+    ArenaThread* thread                 = get_arena_thread();
+    MemoryNamespaceStatistic* statistic = &thread->statistics[arena_index];
+
+    void* block = arena_malloc(thread, arena_index, size);
+
+    if (block == NULL) {
+        statistic->faulty_allocations++;
+    } else {
+        statistic->allocation_count++;
+        statistic->bytes_allocated += size;
+    }
+
+    return block;
+}
+
+static void* arena_resize(size_t arena_index, void* block, size_t size) {
+    ArenaThread* thread                 = get_arena_thread();
+    MemoryNamespaceStatistic* statistic = &thread->statistics[arena_index];
+
+    void* reallocated_block = arena_realloc(thread, arena_index, block, size);
+
+    if (reallocated_block == NULL) {
+        statistic->faulty_reallocations++;
+    } else {
+        statistic->bytes_allocated += size;
+        statistic->reallocation_count++;
+    }
+
+    return reallocated_block;
+}
+
+static void arena_purge(MemoryNamespaceRef memoryNamespace) {
+    ArenaSlab* slab = memoryNamespace->slabs;
+
+    while (slab != NULL) {
+        ArenaSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    memoryNamespace->slabs = NULL;
+
+    // other threads must not allocate from the namespace while it is purged
+    const int index = memoryNamespace->arena_index;
+    for (guint i = 0; arena_threads != NULL && i < arena_threads->len; i++) {
+        ArenaThread* thread = g_ptr_array_index(arena_threads, i);
+
+        memoryNamespace->statistic.purged_free_count +=
+          thread->block_counts[index];
+        thread->block_counts[index] = 0;
+        thread->slabs[index]        = NULL;
+    }
+}
+
+static MemoryNamespaceStatistic
+  namespace_get_statistic(MemoryNamespaceRef memoryNamespace) {
+    MemoryNamespaceStatistic statistic = memoryNamespace->statistic;
+
+    const int index = memoryNamespace->arena_index;
+    if (index < 0 || arena_threads == NULL) {
+        return statistic;
+    }
+
+    for (guint i = 0; i < arena_threads->len; i++) {
+        const ArenaThread* thread = g_ptr_array_index(arena_threads, i);
+        const MemoryNamespaceStatistic* thread_statistic =
+          &thread->statistics[index];
+
+        statistic.bytes_allocated += thread_statistic->bytes_allocated;
+        statistic.allocation_count += thread_statistic->allocation_count;
+        statistic.reallocation_count += thread_statistic->reallocation_count;
+        statistic.faulty_allocations += thread_statistic->faulty_allocations;
+        statistic.faulty_reallocations +=
+          thread_statistic->faulty_reallocations;
+    }
+
+    return statistic;
+}
+
+static void namespace_track_block(MemoryNamespaceRef memoryNamespace,
+                                  MemoryBlock block) {
+    g_hash_table_insert(memoryNamespace->blocks, block.block_ptr,
+                        GUINT_TO_POINTER(block.kind));
+    g_hash_table_insert(block_index, block.block_ptr, memoryNamespace);
+}
+
+static void namespace_untrack_block(MemoryNamespaceRef memoryNamespace,
+                                    void* block) {
+    g_hash_table_remove(memoryNamespace->blocks, block);
+    g_hash_table_remove(block_index, block);
+}
+
 static void* namespace_malloc(MemoryNamespaceRef memoryNamespace, size_t size) {
     assert(memoryNamespace != NULL);
     assert(size != 0);
 
     MemoryBlock block;
-    block.block_ptr = malloc(size);
     block.kind      = GenericBlock;
+    block.block_ptr = malloc(size);
 
     if (block.block_ptr == NULL) {
         memoryNamespace->statistic.faulty_allocations++;
     } else {
-        g_array_append_val(memoryNamespace->blocks, block);
+        namespace_track_block(memoryNamespace, block);
 
         memoryNamespace->statistic.allocation_count++;
         memoryNamespace->statistic.bytes_allocated += size;
+        total_allocation_count++;
     }
 
     return block.block_ptr;
@@ -97,76 +397,98 @@ static void namespace_free_block(MemoryBlock block) {
 
 static gboolean namespace_free(MemoryNamespaceRef memoryNamespace,
                                void* block) {
-    for (guint i = 0; i < memoryNamespace->blocks->len; i++) {
-        MemoryBlock current_block =
-          g_array_index(memoryNamespace->blocks, MemoryBlock, i);
+    gpointer kind = NULL;
 
-        if (current_block.block_ptr == block) {
-            assert(block != NULL);
+    if (!g_hash_table_lookup_extended(memoryNamespace->blocks, block, NULL,
+                                      &kind)) {
+        return FALSE;
+    }
 
-            namespace_free_block(current_block);
+    assert(block != NULL);
 
-            g_array_remove_index(memoryNamespace->blocks, i);
+    MemoryBlock current_block;
+    current_block.block_ptr = block;
+    current_block.kind      = GPOINTER_TO_UINT(kind);
 
-            memoryNamespace->statistic.manual_free_count++;
+    namespace_untrack_block(memoryNamespace, block);
+    namespace_free_block(current_block);
 
-            return TRUE;
-        }
-    }
-    return FALSE;
+    memoryNamespace->statistic.manual_free_count++;
+
+    return TRUE;
 }
 
 static void* namespace_realloc(MemoryNamespaceRef memoryNamespace, void* block,
                                size_t size) {
-    void* reallocated_block = NULL;
-
-    for (guint i = 0; i < memoryNamespace->blocks->len; i++) {
-        MemoryBlock current_block =
-          g_array_index(memoryNamespace->blocks, MemoryBlock, i);
+    if (!g_hash_table_contains(memoryNamespace->blocks, block)) {
+        return NULL;
+    }
 
-        if (current_block.block_ptr == block) {
-            reallocated_block = realloc(current_block.block_ptr, size);
+    void* reallocated_block = realloc(block, size);
 
-            if (reallocated_block != NULL) {
-                g_array_index(memoryNamespace->blocks, MemoryBlock, i)
-                  .block_ptr = reallocated_block;
-                memoryNamespace->statistic.bytes_allocated += size;
-                memoryNamespace->statistic.reallocation_count++;
-            } else {
-                memoryNamespace->statistic.faulty_reallocations++;
-            }
+    if (reallocated_block != NULL) {
+        if (reallocated_block != block) {
+            MemoryBlock reallocated;
+            reallocated.block_ptr = reallocated_block;
+            reallocated.kind      = GenericBlock;
 
-            break;
+            namespace_untrack_block(memoryNamespace, block);
+            namespace_track_block(memoryNamespace, reallocated);
         }
+
+        memoryNamespace->statistic.bytes_allocated += size;
+        memoryNamespace->statistic.reallocation_count++;
+    } else {
+        memoryNamespace->statistic.faulty_reallocations++;
     }
 
     return reallocated_block;
 }
 
 static void namespace_delete(MemoryNamespaceRef memoryNamespace) {
-    g_array_free(memoryNamespace->blocks, TRUE);
+    g_hash_table_destroy(memoryNamespace->blocks);
     free(memoryNamespace);
 }
 
 static void namespace_purge(MemoryNamespaceRef memoryNamespace) {
+    GHashTableIter iter;
+    gpointer block;
+    gpointer kind;
 
-    for (guint i = 0; i < memoryNamespace->blocks->len; i++) {
-        MemoryBlock current_block =
-          g_array_index(memoryNamespace->blocks, MemoryBlock, i);
+    g_hash_table_iter_init(&iter, memoryNamespace->blocks);
+    while (g_hash_table_iter_next(&iter, &block, &kind)) {
+        MemoryBlock current_block;
+        current_block.block_ptr = block;
+        current_block.kind      = GPOINTER_TO_UINT(kind);
 
+        g_hash_table_remove(block_index, block);
         namespace_free_block(current_block);
 
         memoryNamespace->statistic.purged_free_count++;
     }
 
-    g_array_remove_range(memoryNamespace->blocks, 0,
-                         memoryNamespace->blocks->len);
+    g_hash_table_remove_all(memoryNamespace->blocks);
+
+    if (memoryNamespace->arena_index >= 0) {
+        arena_purge(memoryNamespace);
+    }
+}
+
+static int get_arena_index(MemoryNamespaceName name) {
+    for (size_t i = 0; i < ARENA_NAMESPACE_COUNT; i++) {
+        if (strcmp(arena_namespaces[i], name) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
 }
 
-static MemoryNamespaceRef namespace_new() {
+static MemoryNamespaceRef namespace_new(MemoryNamespaceName name) {
     MemoryNamespaceRef memoryNamespace = malloc(sizeof(MemoryNamespace));
 
-    memoryNamespace->blocks = g_array_new(FALSE, FALSE, sizeof(MemoryBlock));
+    memoryNamespace->blocks = g_hash_table_new(g_direct_hash, g_direct_equal);
+    memoryNamespace->arena_index = get_arena_index(name);
+    memoryNamespace->slabs       = NULL;
     memoryNamespace->statistic.bytes_allocated      = 0;
     memoryNamespace->statistic.allocation_count     = 0;
     memoryNamespace->statistic.manual_free_count    = 0;
@@ -183,7 +505,7 @@ GArray* namespace_new_g_array(MemoryNamespaceRef namespace, guint size) {
     block.block_ptr = g_array_new(FALSE, FALSE, size);
     block.kind      = GLIB_Array;
 
-    g_array_append_val(namespace->blocks, block);
+    namespace_track_block(namespace, block);
     namespace->statistic.bytes_allocated += sizeof(GArray*);
     namespace->statistic.allocation_count++;
 
@@ -197,7 +519,7 @@ GHashTable* namespace_new_g_hash_table(MemoryNamespaceRef namespace,
     block.block_ptr = g_hash_table_new(hash_func, key_equal_func);
     block.kind      = GLIB_HashTable;
 
-    g_array_append_val(namespace->blocks, block);
+    namespace_track_block(namespace, block);
     namespace->statistic.bytes_allocated += sizeof(GHashTable*);
     namespace->statistic.allocation_count++;
 
@@ -224,6 +546,12 @@ static void cleanup() {
         namespace_purge(memoryNamespace);
         namespace_delete(memoryNamespace);
     }
+
+    if (arena_threads != NULL) {
+        g_ptr_array_foreach(arena_threads, (GFunc) free, NULL);
+        g_ptr_array_free(arena_threads, TRUE);
+        arena_threads = NULL;
+    }
 }
 
 void mem_init() {
@@ -232,7 +560,8 @@ void mem_init() {
 
 static MemoryNamespaceRef check_namespace(MemoryNamespaceName name) {
     if (namespaces == NULL) {
-        namespaces = g_hash_table_new(g_str_hash, g_str_equal);
+        namespaces  = g_hash_table_new(g_str_hash, g_str_equal);
+        block_index = g_hash_table_new(g_direct_hash, g_direct_equal);
     }
 
     if (g_hash_table_contains(namespaces, name)) {
@@ -240,7 +569,7 @@ static MemoryNamespaceRef check_namespace(MemoryNamespaceName name) {
         return g_hash_table_lookup(namespaces, name);
 
     } else {
-        MemoryNamespaceRef namespace = namespace_new();
+        MemoryNamespaceRef namespace = namespace_new(name);
 
         g_hash_table_insert(namespaces, name, namespace);
 
@@ -249,47 +578,79 @@ static MemoryNamespaceRef check_namespace(MemoryNamespaceName name) {
 }
 
 void* mem_alloc(MemoryNamespaceName name, size_t size) {
+    const int arena_index = get_arena_index(name);
+
+    if (arena_index >= 0) {
+        return arena_alloc(arena_index, size);
+    }
+
+    g_mutex_lock(&cache_lock);
+
     MemoryNamespaceRef cache = check_namespace(name);
 
     if (cache == NULL) {
         PANIC("memory namespace not created");
     }
 
-    return namespace_malloc(cache, size);
+    void* block = namespace_malloc(cache, size);
+
+    g_mutex_unlock(&cache_lock);
+
+    return block;
 }
 
 void* mem_realloc(MemoryNamespaceName name, void* ptr, size_t size) {
+    const int arena_index = get_arena_index(name);
+
+    if (arena_index >= 0) {
+        return arena_resize(arena_index, ptr, size);
+    }
+
+    g_mutex_lock(&cache_lock);
+
     MemoryNamespaceRef cache = check_namespace(name);
 
     if (cache == NULL) {
         PANIC("memory namespace not created");
     }
 
-    return namespace_realloc(cache, ptr, size);
+    void* block = namespace_realloc(cache, ptr, size);
+
+    g_mutex_unlock(&cache_lock);
+
+    return block;
 }
 
 void mem_free_from(MemoryNamespaceName name, void* memory) {
+    g_mutex_lock(&cache_lock);
+
     MemoryNamespaceRef cache = check_namespace(name);
 
     namespace_free(cache, memory);
+
+    g_mutex_unlock(&cache_lock);
 }
 
 void mem_free(void* memory) {
-    GHashTableIter iter;
-    char* name;
-    MemoryNamespaceRef memoryNamespace;
+    g_mutex_lock(&cache_lock);
 
-    g_hash_table_iter_init(&iter, namespaces);
-    while (g_hash_table_iter_next(&iter, (gpointer) &name,
-                                  (gpointer) &memoryNamespace)) {
+    if (block_index != NULL) {
+        MemoryNamespaceRef memoryNamespace =
+          g_hash_table_lookup(block_index, memory);
 
-        if (namespace_free(memoryNamespace, memory)) {
-            break;
+        // blocks of arena namespaces are not indexed and
+        // only released by purging
+        if (memoryNamespace != NULL) {
+            namespace_free(memoryNamespace, memory);
         }
     }
+
+    g_mutex_unlock(&cache_lock);
 }
 
 void mem_purge_namespace(MemoryNamespaceName name) {
+    g_mutex_lock(&cache_lock);
+
     if (g_hash_table_contains(namespaces, name)) {
         MemoryNamespaceRef cache = g_hash_table_lookup(namespaces, name);
 
@@ -297,6 +658,8 @@ void mem_purge_namespace(MemoryNamespaceName name) {
     } else {
         WARN("purging invalid namespace: %s", name);
     }
+
+    g_mutex_unlock(&cache_lock);
 }
 
 char* mem_strdup(MemoryNamespaceName name, char* string) {
@@ -311,6 +674,25 @@ void* mem_clone(MemoryNamespaceName name, void* data, size_t size) {
     return clone;
 }
 
+size_t mem_get_allocation_count(void) {
+    g_mutex_lock(&cache_lock);
+
+    size_t count = total_allocation_count;
+
+    // counters of threads still allocating may lag behind
+    for (guint i = 0; arena_threads != NULL && i < arena_threads->len; i++) {
+        const ArenaThread* thread = g_ptr_array_index(arena_threads, i);
+
+        for (size_t k = 0; k < ARENA_NAMESPACE_COUNT; k++) {
+            count += thread->statistics[k].allocation_count;
+        }
+    }
+
+    g_mutex_unlock(&cache_lock);
+
+    return count;
+}
+
 void print_memory_statistics() {
     GHashTableIter iter;
     char* name;
@@ -328,19 +710,18 @@ void print_memory_statistics() {
     g_hash_table_iter_init(&iter, namespaces);
     while (g_hash_table_iter_next(&iter, (gpointer) &name,
                                   (gpointer) &memoryNamespace)) {
-
-        namespace_statistics_print(&memoryNamespace->statistic, name);
-
-        total.bytes_allocated += memoryNamespace->statistic.bytes_allocated;
-        total.faulty_reallocations +=
-          memoryNamespace->statistic.faulty_reallocations;
-        total.faulty_allocations +=
-          memoryNamespace->statistic.faulty_allocations;
-        total.manual_free_count += memoryNamespace->statistic.manual_free_count;
-        total.allocation_count += memoryNamespace->statistic.allocation_count;
-        total.purged_free_count += memoryNamespace->statistic.purged_free_count;
-        total.reallocation_count +=
-          memoryNamespace->statistic.reallocation_count;
+        MemoryNamespaceStatistic statistic =
+          namespace_get_statistic(memoryNamespace);
+
+        namespace_statistics_print(&statistic, name);
+
+        total.bytes_allocated += statistic.bytes_allocated;
+        total.faulty_reallocations += statistic.faulty_reallocations;
+        total.faulty_allocations += statistic.faulty_allocations;
+        total.manual_free_count += statistic.manual_free_count;
+        total.allocation_count += statistic.allocation_count;
+        total.purged_free_count += statistic.purged_free_count;
+        total.reallocation_count += statistic.reallocation_count;
     }
 
     namespace_statistics_print(&total, "summary");
@@ -350,22 +731,35 @@ void print_memory_statistics() {
 }
 
 GArray* mem_new_g_array(MemoryNamespaceName name, guint element_size) {
+    g_mutex_lock(&cache_lock);
+
     MemoryNamespaceRef cache = check_namespace(name);
 
     if (cache == NULL) {
         PANIC("memory namespace not created");
     }
 
-    return namespace_new_g_array(cache, element_size);
+    GArray* array = namespace_new_g_array(cache, element_size);
+
+    g_mutex_unlock(&cache_lock);
+
+    return array;
 }
 
 GHashTable* mem_new_g_hash_table(MemoryNamespaceName name, GHashFunc hash_func,
                                  GEqualFunc key_equal_func) {
+    g_mutex_lock(&cache_lock);
+
     MemoryNamespaceRef cache = check_namespace(name);
 
     if (cache == NULL) {
         PANIC("memory namespace not created");
     }
 
-    return namespace_new_g_hash_table(cache, hash_func, key_equal_func);
+    GHashTable* table =
+      namespace_new_g_hash_table(cache, hash_func, key_equal_func);
+
+    g_mutex_unlock(&cache_lock);
+
+    return table;
 }
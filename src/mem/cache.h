@@ -21,6 +21,7 @@ typedef char* MemoryNamespaceName;
 #define MemoryNamespaceLld    "LLD"
 #define MemoryNamespaceIo     "I/O"
 #define MemoryNamespaceStatic "Static"
+#define MemoryNamespaceSymbol "Symbol"
 
 /**
  * @brief Initialize the garbage collector.
@@ -30,6 +31,8 @@ void mem_init();
 
 /**
  * @brief Allocate a block of memory in the specified namespace.
+ *        Arena namespaces serve every thread from its own slab, so threads
+ *        allocating from them do not wait on each other.
  * @attention Must only be freed with mem_free() or mem_free_from()
  * @param name
  * @param size
@@ -57,6 +60,8 @@ void mem_free_from(MemoryNamespaceName name, void* memory);
 /**
  * @brief Free a block of memory.
  *        Invoking multiple times on the same pointer will do nothing.
+ *        Generic blocks of arena namespaces (AST, Lexer, SET, Symbol) are only
+ *        released once their namespace is purged.
  * @attention In case the namespace of the block is known, consider using
  * mem_free_from() to avoid unnecessary overhead.
  * @param name
@@ -66,6 +71,8 @@ void mem_free(void* memory);
 
 /**
  * @brief Delete all memory from the given namespace.
+ *        Arena namespaces release the slabs of all threads at once.
+ * @attention No other thread may allocate from the namespace meanwhile
  * @param name
  */
 void mem_purge_namespace(MemoryNamespaceName name);
@@ -89,6 +96,13 @@ void* mem_clone(MemoryNamespaceName name, void* data, size_t size);
 
 void print_memory_statistics();
 
+/**
+ * @brief Get the number of allocations made from all namespaces since
+ *        startup.
+ * @return
+ */
+size_t mem_get_allocation_count(void);
+
 GArray* mem_new_g_array(MemoryNamespaceName name, guint element_size);
 
 GHashTable* mem_new_g_hash_table(MemoryNamespaceName name, GHashFunc hash_func,
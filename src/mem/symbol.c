@@ -0,0 +1,120 @@
+#include <assert.h>
+#include <mem/symbol.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/log.h>
+
+typedef struct SymbolEntry_t {
+    // points to string or the text of a lookup key
+    const char* text;
+    guint hash;
+    guint length;
+    char string[];
+} SymbolEntry;
+
+#define SYMBOL_ENTRY(symbol) \
+    ((const SymbolEntry*) ((symbol) - offsetof(SymbolEntry, string)))
+
+// number of independently locked parts of the symbol table
+#define SYMBOL_SHARD_COUNT 64
+
+/**
+ * @brief Part of the symbol table holding all symbols whose hash maps to it.
+ *        Files are lexed concurrently, separate locks per shard keep threads
+ *        interning different symbols from waiting on each other.
+ */
+typedef struct SymbolShard_t {
+    GMutex lock;
+    // set of symbol entries
+    GHashTable* symbols;
+} SymbolShard;
+
+static SymbolShard shards[SYMBOL_SHARD_COUNT];
+
+static guint hash_text(const char* text, size_t length) {
+    // FNV-1a
+    guint hash = 2166136261u;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) text[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static guint entry_hash(gconstpointer entry) {
+    return ((const SymbolEntry*) entry)->hash;
+}
+
+static gboolean entry_equal(gconstpointer a, gconstpointer b) {
+    const SymbolEntry* left  = a;
+    const SymbolEntry* right = b;
+
+    return left->length == right->length
+           && memcmp(left->text, right->text, left->length) == 0;
+}
+
+Symbol symbol_intern_length(const char* string, size_t length) {
+    assert(string != NULL);
+
+    if (length > G_MAXUINT) {
+        PANIC("symbol exceeds maximum length: %zu", length);
+    }
+
+    SymbolEntry key;
+    key.text   = string;
+    key.hash   = hash_text(string, length);
+    key.length = (guint) length;
+
+    // the upper bits of the hash select the shard, tables index
+    // with the lower ones
+    SymbolShard* shard = &shards[(key.hash >> 24) % SYMBOL_SHARD_COUNT];
+
+    g_mutex_lock(&shard->lock);
+
+    if (shard->symbols == NULL) {
+        shard->symbols = g_hash_table_new(entry_hash, entry_equal);
+    }
+
+    SymbolEntry* entry = g_hash_table_lookup(shard->symbols, &key);
+
+    if (entry == NULL) {
+        entry = mem_alloc(MemoryNamespaceSymbol,
+                          sizeof(SymbolEntry) + length + 1);
+
+        if (entry == NULL) {
+            PANIC("failed to allocate symbol");
+        }
+
+        memcpy(entry->string, string, length);
+        entry->string[length] = '\0';
+        entry->text           = entry->string;
+        entry->hash           = key.hash;
+        entry->length         = key.length;
+
+        g_hash_table_add(shard->symbols, entry);
+    }
+
+    g_mutex_unlock(&shard->lock);
+
+    return entry->string;
+}
+
+Symbol symbol_intern(const char* string) {
+    return symbol_intern_length(string, strlen(string));
+}
+
+guint symbol_hash(gconstpointer symbol) {
+    assert(symbol != NULL);
+
+    return SYMBOL_ENTRY((Symbol) symbol)->hash;
+}
+
+gboolean symbol_equal(gconstpointer a, gconstpointer b) {
+    return a == b;
+}
+
+GHashTable* mem_new_symbol_table(MemoryNamespaceName name) {
+    return mem_new_g_hash_table(name, symbol_hash, symbol_equal);
+}
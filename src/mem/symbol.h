@@ -0,0 +1,60 @@
+#ifndef GEMSTONE_SYMBOL_H
+#define GEMSTONE_SYMBOL_H
+
+#include <glib.h>
+#include <mem/cache.h>
+#include <stddef.h>
+
+/**
+ * @brief An interned, null terminated and immutable string.
+ *        Two symbols are equal if and only if they are the same pointer.
+ *        Symbols live until the program exits.
+ */
+typedef const char* Symbol;
+
+/**
+ * @brief Return the unique symbol for the given string.
+ *        May be called concurrently.
+ * @param string
+ * @return
+ */
+[[gnu::nonnull(1)]]
+Symbol symbol_intern(const char* string);
+
+/**
+ * @brief Return the unique symbol for the first length bytes of the given
+ *        string. The string does not need to be null terminated.
+ * @param string
+ * @param length
+ * @return
+ */
+[[gnu::nonnull(1)]]
+Symbol symbol_intern_length(const char* string, size_t length);
+
+/**
+ * @brief Hash function for symbols. Returns the hash precomputed at the time
+ *        the symbol was interned. The hash depends only on the content of
+ *        the symbol so iterating tables keyed by symbols is deterministic.
+ * @attention Only valid on strings returned by symbol_intern()
+ * @param symbol
+ * @return
+ */
+guint symbol_hash(gconstpointer symbol);
+
+/**
+ * @brief Equality function for symbols, compares the pointers only.
+ * @param a
+ * @param b
+ * @return
+ */
+gboolean symbol_equal(gconstpointer a, gconstpointer b);
+
+/**
+ * @brief Create a new hash table keyed by symbols in the given namespace.
+ *        All keys inserted and looked up must be interned.
+ * @param name
+ * @return
+ */
+GHashTable* mem_new_symbol_table(MemoryNamespaceName name);
+
+#endif // GEMSTONE_SYMBOL_H
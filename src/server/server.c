@@ -0,0 +1,522 @@
+//
+// Compile server and client.
+//
+// A request consists of the standard output and error of the client passed
+// as file descriptors, followed by the number of arguments, the working
+// directory of the client and its arguments. Each string is prefixed with
+// its length. The server responds with the exit status of the compilation.
+//
+
+#include <cfg/opt.h>
+#include <codegen/backend.h>
+#include <compiler.h>
+#include <io/files.h>
+#include <llvm/backend.h>
+#include <mem/cache.h>
+#include <server/server.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/col.h>
+#include <sys/log.h>
+
+#ifdef __unix__
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// upper bound of the number of arguments of a single request
+#define SERVER_MAX_ARGUMENTS 4096
+// upper bound of the length of a single argument
+#define SERVER_MAX_STRING (1 << 20)
+
+#ifdef __unix__
+
+/**
+ * @brief Get the path to the socket of the server as given by the option or
+ *        the default path in the runtime directory of the user.
+ * @param option name of the option specifying the path
+ * @return path which must be freed with g_free()
+ */
+static char* get_socket_path(const char* option) {
+    const Option* opt = get_option(option);
+
+    if (opt != NULL && opt->value != NULL) {
+        return g_strdup(opt->value);
+    }
+
+    return g_build_filename(g_get_user_runtime_dir(), SERVER_SOCKET_NAME,
+                            NULL);
+}
+
+static volatile sig_atomic_t server_running = 1;
+
+static void stop_server([[maybe_unused]] int signal) {
+    server_running = 0;
+}
+
+static bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = data;
+
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        bytes += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+static bool read_all(int fd, void* data, size_t size) {
+    char* bytes = data;
+
+    while (size > 0) {
+        ssize_t bytes_read = read(fd, bytes, size);
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        // connection closed
+        if (bytes_read == 0) {
+            return false;
+        }
+
+        bytes += bytes_read;
+        size -= bytes_read;
+    }
+
+    return true;
+}
+
+static bool write_string(int fd, const char* string) {
+    guint32 length = (guint32) strlen(string);
+
+    return write_all(fd, &length, sizeof(length))
+           && write_all(fd, string, length);
+}
+
+/**
+ * @brief Read a length prefixed string.
+ * @param fd
+ * @return string which must be freed with g_free() or NULL on failure
+ */
+static char* read_string(int fd) {
+    guint32 length = 0;
+
+    if (!read_all(fd, &length, sizeof(length))
+        || length > SERVER_MAX_STRING) {
+        return NULL;
+    }
+
+    char* string = g_malloc(length + 1);
+    if (!read_all(fd, string, length)) {
+        g_free(string);
+        return NULL;
+    }
+    string[length] = 0;
+
+    return string;
+}
+
+/**
+ * @brief Pass the standard output and error of this process to the server.
+ * @param fd socket connected to the server
+ * @return true on success
+ */
+static bool send_output(int fd) {
+    int fds[2] = {STDOUT_FILENO, STDERR_FILENO};
+    char byte  = 0;
+
+    struct iovec iov = {.iov_base = &byte, .iov_len = sizeof(byte)};
+
+    union {
+        char buffer[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov        = &iov;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level     = SOL_SOCKET;
+    header->cmsg_type      = SCM_RIGHTS;
+    header->cmsg_len       = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(header), fds, sizeof(fds));
+
+    return sendmsg(fd, &message, 0) == sizeof(byte);
+}
+
+/**
+ * @brief Receive the standard output and error of the client.
+ * @param fd socket connected to the client
+ * @param fds output for the file descriptors
+ * @return true on success
+ */
+static bool receive_output(int fd, int fds[2]) {
+    char byte = 0;
+
+    struct iovec iov = {.iov_base = &byte, .iov_len = sizeof(byte)};
+
+    union {
+        char buffer[CMSG_SPACE(sizeof(int) * 2)];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov        = &iov;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    if (recvmsg(fd, &message, 0) != sizeof(byte)) {
+        return false;
+    }
+
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (header == NULL || header->cmsg_level != SOL_SOCKET
+        || header->cmsg_type != SCM_RIGHTS
+        || header->cmsg_len != CMSG_LEN(sizeof(int) * 2)) {
+        return false;
+    }
+
+    memcpy(fds, CMSG_DATA(header), sizeof(int) * 2);
+
+    return true;
+}
+
+static bool create_socket_address(struct sockaddr_un* address,
+                                  const char* path) {
+    if (strlen(path) >= sizeof(address->sun_path)) {
+        print_message(Error, "Path to socket is too long: %s", path);
+        return false;
+    }
+
+    memset(address, 0, sizeof(struct sockaddr_un));
+    address->sun_family = AF_UNIX;
+    strcpy(address->sun_path, path);
+
+    return true;
+}
+
+/**
+ * @brief Connect to the server listening on the given socket.
+ * @param path
+ * @return file descriptor of the connection or -1 on failure
+ */
+static int connect_server(const char* path) {
+    struct sockaddr_un address;
+    if (!create_socket_address(&address, path)) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * @brief Pay for everything that is shared by all requests once:
+ *        backend initialization, target machines for the host and
+ *        parsing of the modules in the import paths.
+ * @return EXIT_SUCCESS if successful EXIT_FAILURE otherwise
+ */
+static int warm_up(void) {
+    DEBUG("initializing LLVM codegen backend...");
+    llvm_backend_init();
+
+    BackendError err = init_backend();
+    if (err.kind != Success) {
+        print_message(Error, "Unable to initialize backend: %s",
+                      err.impl.message);
+        return EXIT_FAILURE;
+    }
+
+    for (int level = 1; level <= 3; level++) {
+        TargetConfig* config       = default_target_config();
+        config->optimization_level = level;
+
+        Target target                = create_target_from_config(config);
+        LLVMTargetMachineRef machine = NULL;
+
+        err = get_target_machine(&target, &machine);
+        if (err.kind == Success) {
+            release_target_machine(&target, machine);
+        }
+
+        delete_target(target);
+        delete_target_config(config);
+
+        if (err.kind != Success) {
+            print_message(Error, "Unable to create target machine: %s",
+                          err.impl.message);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const Option* opt = get_option("import-paths");
+    if (opt != NULL && opt->value != NULL) {
+        GArray* directories =
+          mem_new_g_array(MemoryNamespaceStatic, sizeof(char*));
+
+        gchar** paths = g_strsplit(opt->value, ",", -1);
+        for (guint i = 0; paths[i] != NULL; i++) {
+            if (paths[i][0] != 0) {
+                g_array_append_val(directories, paths[i]);
+            }
+        }
+
+        preload_modules(directories);
+
+        g_strfreev(paths);
+        mem_free(directories);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Serve a single request of a client. Runs in its own process.
+ * @param fd socket connected to the client
+ */
+[[noreturn]]
+static void serve_request(int fd) {
+    // compilation may spawn and wait for processes on its own
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+
+    int output[2];
+    guint32 argc = 0;
+
+    // clients probing for a running server close without a request
+    if (!receive_output(fd, output)) {
+        INFO("client closed connection without request");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!read_all(fd, &argc, sizeof(argc)) || argc == 0
+        || argc > SERVER_MAX_ARGUMENTS) {
+        ERROR("invalid request of client");
+        exit(EXIT_FAILURE);
+    }
+
+    char* cwd   = read_string(fd);
+    char** argv = g_new0(char*, argc + 1);
+
+    for (guint32 i = 0; i < argc && cwd != NULL; i++) {
+        argv[i] = read_string(fd);
+
+        if (argv[i] == NULL) {
+            ERROR("invalid request of client");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (cwd == NULL) {
+        ERROR("invalid request of client");
+        exit(EXIT_FAILURE);
+    }
+
+    dup2(output[0], STDOUT_FILENO);
+    dup2(output[1], STDERR_FILENO);
+    close(output[0]);
+    close(output[1]);
+
+    gint32 status = EXIT_FAILURE;
+
+    if (chdir(cwd) != 0) {
+        print_message(Error, "Unable to change directory to %s: %s", cwd,
+                      strerror(errno));
+    } else {
+        // act on the options of the client from here on
+        parse_options((int) argc, argv);
+        log_configure();
+        col_init();
+
+        status = run_compiler();
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    if (!write_all(fd, &status, sizeof(status))) {
+        ERROR("failed to send status to client");
+    }
+
+    g_strfreev(argv);
+    g_free(cwd);
+
+    exit(status);
+}
+
+int run_server(void) {
+    char* path = get_socket_path("server");
+
+    struct sockaddr_un address;
+    if (!create_socket_address(&address, path)) {
+        g_free(path);
+        return EXIT_FAILURE;
+    }
+
+    // refuse to replace the socket of a running server
+    int running = connect_server(path);
+    if (running >= 0) {
+        print_message(Error, "Compile server is already running at: %s",
+                      path);
+        close(running);
+        g_free(path);
+        return EXIT_FAILURE;
+    }
+    unlink(path);
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0
+        || bind(server, (struct sockaddr*) &address, sizeof(address)) != 0
+        || listen(server, SOMAXCONN) != 0) {
+        print_message(Error, "Unable to listen on %s: %s", path,
+                      strerror(errno));
+        if (server >= 0) {
+            close(server);
+        }
+        g_free(path);
+        return EXIT_FAILURE;
+    }
+
+    int status = warm_up();
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    // no SA_RESTART, accept() must return on shutdown
+    action.sa_handler = stop_server;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // workers are never waited for
+    signal(SIGCHLD, SIG_IGN);
+
+    if (status == EXIT_SUCCESS) {
+        print_message(Info, "Compile server listening on: %s", path);
+    }
+    fflush(stdout);
+
+    while (server_running && status == EXIT_SUCCESS) {
+        int client = accept(server, NULL, NULL);
+        if (client < 0) {
+            if (errno != EINTR) {
+                print_message(Error, "Unable to accept client: %s",
+                              strerror(errno));
+                status = EXIT_FAILURE;
+            }
+            continue;
+        }
+
+        // prevent buffered output from being duplicated into workers
+        fflush(stdout);
+        fflush(stderr);
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(server);
+            serve_request(client);
+        } else if (pid < 0) {
+            print_message(Error, "Unable to serve client: %s",
+                          strerror(errno));
+        }
+
+        close(client);
+    }
+
+    INFO("shutting down compile server...");
+
+    close(server);
+    unlink(path);
+    g_free(path);
+
+    return status;
+}
+
+bool run_client(int argc, char* argv[], int* status) {
+    char* path = get_socket_path("client");
+
+    int server = connect_server(path);
+    if (server < 0) {
+        INFO("no compile server running at: %s", path);
+        g_free(path);
+        return false;
+    }
+    g_free(path);
+
+    // forward all arguments except the one selecting the server
+    guint32 count = 0;
+    for (int i = 0; i < argc; i++) {
+        if (!g_str_has_prefix(argv[i], "--client")) {
+            count++;
+        }
+    }
+
+    char* cwd = g_get_current_dir();
+
+    bool sent = send_output(server) && write_all(server, &count, sizeof(count))
+                && write_string(server, cwd);
+    for (int i = 0; i < argc && sent; i++) {
+        if (!g_str_has_prefix(argv[i], "--client")) {
+            sent = write_string(server, argv[i]);
+        }
+    }
+
+    g_free(cwd);
+
+    gint32 result = EXIT_FAILURE;
+    if (!sent || !read_all(server, &result, sizeof(result))) {
+        print_message(Error, "Connection to compile server was lost");
+        result = EXIT_FAILURE;
+    }
+
+    close(server);
+
+    *status = result;
+
+    return true;
+}
+
+#else
+
+int run_server(void) {
+    print_message(Error, "The compile server is not supported on this "
+                         "platform");
+    return EXIT_FAILURE;
+}
+
+bool run_client([[maybe_unused]] int argc, [[maybe_unused]] char* argv[],
+                [[maybe_unused]] int* status) {
+    return false;
+}
+
+#endif
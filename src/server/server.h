@@ -0,0 +1,39 @@
+//
+// Compile server. A server keeps an initialized compiler process with its
+// backend, target machines and preloaded modules alive and builds on behalf
+// of clients connecting to it through a local socket. Every request is
+// served by a forked copy of the warm process. Preloaded modules are only
+// parsed, semantic analysis still runs for every request.
+//
+
+#ifndef GEMSTONE_SERVER_H
+#define GEMSTONE_SERVER_H
+
+#include <stdbool.h>
+
+#define SERVER_SOCKET_NAME "gsc.sock"
+
+/**
+ * @brief Run the compile server until it is interrupted.
+ *        The socket is given by --server=path and defaults to gsc.sock
+ *        in the runtime directory of the user. Modules below the
+ *        directories given by --import-paths are preloaded.
+ * @return EXIT_SUCCESS if the server was shut down properly
+ */
+int run_server(void);
+
+/**
+ * @brief Forward the command line to a running compile server which
+ *        compiles in the current working directory and writes to the
+ *        standard output and error of this process.
+ *        The socket is given by --client=path with the same default as
+ *        for the server.
+ * @param argc
+ * @param argv
+ * @param status exit status of the compilation
+ * @return true if a server handled the request, false if no server is
+ *         running
+ */
+bool run_client(int argc, char* argv[], int* status);
+
+#endif // GEMSTONE_SERVER_H
@@ -3,6 +3,7 @@
 #include <glib.h>
 #include <io/files.h>
 #include <mem/cache.h>
+#include <mem/symbol.h>
 #include <set/set.h>
 #include <set/types.h>
 #include <string.h>
@@ -14,9 +15,15 @@ static GHashTable* declaredBoxes     = NULL;  // pointer to type
 static GHashTable* functionParameter = NULL;
 static GHashTable* definedFunctions  = NULL;
 static GHashTable* declaredFunctions = NULL;
-static GArray* Scope =
-  NULL; // list of hashtables. last Hashtable is current depth of program.
-        // hashtable key: ident, value: Variable* to var
+static GHashTable* Scope =
+  NULL; // maps every variable name to the stack of its bindings.
+        // hashtable key: ident, value: GArray* of Variable*, innermost last
+static GArray* ScopeLog =
+  NULL; // names bound by all open scopes in order of binding
+static GArray* ScopeMarks =
+  NULL; // length of ScopeLog at the time each open scope was entered
+static GHashTable* canonicalTypes =
+  NULL; // every distinct type of the module exactly once
 
 int createTypeCastFromExpression(Expression* expression, Type* resultType,
                                  Expression** result);
@@ -40,6 +47,75 @@ const Type StringLiteralType = {
     .nodePtr = NULL,
 };
 
+static guint hash_type(gconstpointer data) {
+    const Type* type = data;
+    guint hash       = type->kind;
+
+    switch (type->kind) {
+        case TypeKindPrimitive:
+            hash = hash * 31 + type->impl.primitive;
+            break;
+        case TypeKindComposite:
+            hash = hash * 31 + type->impl.composite.primitive;
+            hash = hash * 31 + type->impl.composite.sign;
+            hash = hash * 31 + g_double_hash(&type->impl.composite.scale);
+            break;
+        case TypeKindBox:
+            hash = hash * 31 + g_direct_hash(type->impl.box);
+            break;
+        case TypeKindReference:
+            hash = hash * 31 + g_direct_hash(type->impl.reference);
+            break;
+    }
+
+    return hash;
+}
+
+static gboolean equal_types(gconstpointer a, gconstpointer b) {
+    const Type* left  = a;
+    const Type* right = b;
+
+    if (left->kind != right->kind) {
+        return FALSE;
+    }
+
+    switch (left->kind) {
+        case TypeKindPrimitive:
+            return left->impl.primitive == right->impl.primitive;
+        case TypeKindComposite:
+            return left->impl.composite.primitive
+                     == right->impl.composite.primitive
+                   && left->impl.composite.sign == right->impl.composite.sign
+                   && left->impl.composite.scale
+                        == right->impl.composite.scale;
+        case TypeKindBox:
+            return left->impl.box == right->impl.box;
+        case TypeKindReference:
+            // referenced types are canonical themselves
+            return left->impl.reference == right->impl.reference;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Get the canonical instance of a type. Every distinct type is
+ *        created once, thus types are equal if and only if their pointers
+ *        are equal. Canonical types must not be modified.
+ * @param type prototype of the type, referenced types must be canonical
+ * @return the canonical type, the prototype is copied if it is new
+ */
+static Type* intern_type(const Type* type) {
+    Type* canonical = g_hash_table_lookup(canonicalTypes, type);
+
+    if (canonical == NULL) {
+        canonical = mem_clone(MemoryNamespaceSet, (void*) type, sizeof(Type));
+        g_hash_table_add(canonicalTypes, canonical);
+    }
+
+    return canonical;
+}
+
 /**
  * @brief Convert a string into a sign typ
  * @return 0 on success, 1 otherwise
@@ -120,7 +196,7 @@ int merge_scale_list(AST_NODE_PTR scale_list, Scale* scale) {
     assert(scale_list != NULL);
     assert(scale != NULL);
 
-    for (size_t i = 0; i < scale_list->children->len; i++) {
+    for (size_t i = 0; i < scale_list->children.len; i++) {
 
         double scale_in_list = 1.0;
         int scale_invalid =
@@ -244,10 +320,16 @@ int set_impl_reference_type(AST_NODE_PTR currentNode, Type** type) {
     ReferenceType reference;
 
     int status = set_get_type_impl(AST_get_node(currentNode, 0), &reference);
+    if (status == SEMANTIC_ERROR) {
+        return SEMANTIC_ERROR;
+    }
+
+    Type type_reference;
+    type_reference.kind           = TypeKindReference;
+    type_reference.impl.reference = reference;
+    type_reference.nodePtr        = currentNode;
 
-    *type                   = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    (*type)->kind           = TypeKindReference;
-    (*type)->impl.reference = reference;
+    *type = intern_type(&type_reference);
 
     return status;
 }
@@ -261,7 +343,7 @@ int set_impl_reference_type(AST_NODE_PTR currentNode, Type** type) {
 int set_get_type_impl(AST_NODE_PTR currentNode, Type** type) {
     assert(currentNode != NULL);
     assert(currentNode->kind == AST_Type || currentNode->kind == AST_Reference);
-    assert(currentNode->children->len > 0);
+    assert(currentNode->children.len > 0);
     DEBUG("start Type");
 
     int status;
@@ -271,7 +353,7 @@ int set_get_type_impl(AST_NODE_PTR currentNode, Type** type) {
     }
 
     const char* typekind =
-      AST_get_node(currentNode, currentNode->children->len - 1)->value;
+      AST_get_node(currentNode, currentNode->children.len - 1)->value;
 
     // find type in composites
     if (g_hash_table_contains(declaredComposites, typekind) == TRUE) {
@@ -282,7 +364,7 @@ int set_get_type_impl(AST_NODE_PTR currentNode, Type** type) {
     if (g_hash_table_contains(declaredBoxes, typekind) == TRUE) {
         *type = g_hash_table_lookup(declaredBoxes, typekind);
 
-        if (currentNode->children->len > 1) {
+        if (currentNode->children.len > 1) {
             print_diagnostic(&currentNode->location, Error,
                              "Box type cannot modified");
             return SEMANTIC_ERROR;
@@ -291,21 +373,21 @@ int set_get_type_impl(AST_NODE_PTR currentNode, Type** type) {
     }
     // type is not yet declared, make a new one
 
-    Type* new_type    = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    new_type->nodePtr = currentNode;
+    Type new_type;
+    new_type.nodePtr = currentNode;
 
     // only one child means either composite or primitive
     // try to implement primitive first
     // if not successfull continue building a composite
-    if (currentNode->children->len == 1) {
+    if (currentNode->children.len == 1) {
         // type is a primitive
-        new_type->kind = TypeKindPrimitive;
+        new_type.kind = TypeKindPrimitive;
 
-        status = primitive_from_string(typekind, &new_type->impl.primitive);
+        status = primitive_from_string(typekind, &new_type.impl.primitive);
 
         // if err continue at composite construction
         if (status == SEMANTIC_OK) {
-            *type = new_type;
+            *type = intern_type(&new_type);
             return SEMANTIC_OK;
         }
 
@@ -315,10 +397,12 @@ int set_get_type_impl(AST_NODE_PTR currentNode, Type** type) {
         return SEMANTIC_ERROR;
     }
 
-    new_type->kind                   = TypeKindComposite;
-    new_type->impl.composite.nodePtr = currentNode;
-    status = set_impl_composite_type(currentNode, &new_type->impl.composite);
-    *type  = new_type;
+    new_type.kind                   = TypeKindComposite;
+    new_type.impl.composite.nodePtr = currentNode;
+    status = set_impl_composite_type(currentNode, &new_type.impl.composite);
+    if (status == SEMANTIC_OK) {
+        *type = intern_type(&new_type);
+    }
 
     return status;
 }
@@ -343,20 +427,20 @@ int addVarToScope(Variable* variable);
 
 int createRef(AST_NODE_PTR currentNode, Type** reftype) {
     assert(currentNode != NULL);
-    assert(currentNode->children->len == 1);
+    assert(currentNode->children.len == 1);
 
-    Type* type             = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    Type* referenceType    = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    referenceType->kind    = TypeKindReference;
-    referenceType->nodePtr = currentNode;
+    Type* type = NULL;
+    Type referenceType;
+    referenceType.kind    = TypeKindReference;
+    referenceType.nodePtr = currentNode;
 
     AST_NODE_PTR ast_type = AST_get_node(currentNode, 0);
     int signal            = set_get_type_impl(ast_type, &type);
     if (signal) {
         return SEMANTIC_ERROR;
     }
-    referenceType->impl.reference = type;
-    *reftype                      = referenceType;
+    referenceType.impl.reference = type;
+    *reftype                     = intern_type(&referenceType);
     return SEMANTIC_OK;
 }
 
@@ -373,9 +457,9 @@ int createDecl(AST_NODE_PTR currentNode, GArray** variables) {
 
     int status = SEMANTIC_OK;
 
-    DEBUG("Child Count: %i", currentNode->children->len);
+    DEBUG("Child Count: %i", currentNode->children.len);
 
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         switch (AST_get_node(currentNode, i)->kind) {
             case AST_Storage:
                 DEBUG("fill Qualifier");
@@ -399,7 +483,7 @@ int createDecl(AST_NODE_PTR currentNode, GArray** variables) {
         }
     }
 
-    for (size_t i = 0; i < ident_list->children->len; i++) {
+    for (size_t i = 0; i < ident_list->children.len; i++) {
         Variable* variable = mem_alloc(MemoryNamespaceSet, sizeof(Variable));
 
         variable->kind             = VariableKindDeclaration;
@@ -440,8 +524,8 @@ int createDef(AST_NODE_PTR currentNode, GArray** variables) {
 
     int status = SEMANTIC_OK;
 
-    DEBUG("Child Count: %i", declaration->children->len);
-    for (size_t i = 0; i < declaration->children->len; i++) {
+    DEBUG("Child Count: %i", declaration->children.len);
+    for (size_t i = 0; i < declaration->children.len; i++) {
 
         AST_NODE_PTR child = AST_get_node(declaration, i);
 
@@ -489,7 +573,7 @@ int createDef(AST_NODE_PTR currentNode, GArray** variables) {
         def.initializer = name;
     }
 
-    for (size_t i = 0; i < ident_list->children->len; i++) {
+    for (size_t i = 0; i < ident_list->children.len; i++) {
         Variable* variable = mem_alloc(MemoryNamespaceSet, sizeof(Variable));
 
         variable->kind           = VariableKindDefinition;
@@ -580,48 +664,69 @@ int getParameter(const char* name, Parameter** parameter) {
     return SEMANTIC_ERROR;
 }
 
+void enterScope() {
+    guint mark = ScopeLog->len;
+    g_array_append_val(ScopeMarks, mark);
+}
+
+void leaveScope() {
+    assert(ScopeMarks->len > 0);
+
+    guint mark = g_array_index(ScopeMarks, guint, ScopeMarks->len - 1);
+    g_array_remove_index(ScopeMarks, ScopeMarks->len - 1);
+
+    // undo all bindings of the scope
+    while (ScopeLog->len > mark) {
+        const char* name =
+          g_array_index(ScopeLog, const char*, ScopeLog->len - 1);
+        g_array_remove_index(ScopeLog, ScopeLog->len - 1);
+
+        GArray* bindings = g_hash_table_lookup(Scope, name);
+        g_array_remove_index(bindings, bindings->len - 1);
+    }
+}
+
 int getVariableFromScope(const char* name, Variable** variable) {
     assert(name != NULL);
     assert(variable != NULL);
     assert(Scope != NULL);
     DEBUG("getting var from scope");
-    int found = 0;
 
-    for (size_t i = 0; i < Scope->len; i++) {
+    GArray* bindings = g_hash_table_lookup(Scope, name);
 
-        GHashTable* variable_table = g_array_index(Scope, GHashTable*, i);
-
-        if (g_hash_table_contains(variable_table, name)) {
-            if (found == 0) {
-                *variable = g_hash_table_lookup(variable_table, name);
-            }
-            found += 1;
-        }
+    if (bindings == NULL || bindings->len == 0) {
+        DEBUG("nothing found");
+        return SEMANTIC_ERROR;
     }
-    if (found == 1) {
-        DEBUG("Var: %s", (*variable)->name);
-        DEBUG("Var Typekind: %d", (*variable)->kind);
-        DEBUG("Found var");
-        return SEMANTIC_OK;
-    } else if (found > 1) {
+
+    *variable = g_array_index(bindings, Variable*, bindings->len - 1);
+
+    if (bindings->len > 1) {
         print_diagnostic(&(*variable)->nodePtr->location, Warning,
                          "Parameter shadows variable of same name: %s", name);
         return SEMANTIC_OK;
     }
-    DEBUG("nothing found");
-    return SEMANTIC_ERROR;
+
+    DEBUG("Var: %s", (*variable)->name);
+    DEBUG("Var Typekind: %d", (*variable)->kind);
+    DEBUG("Found var");
+    return SEMANTIC_OK;
 }
 
 int addVarToScope(Variable* variable) {
-    Variable* tmp = NULL;
-    if (getVariableFromScope(variable->name, &tmp) == SEMANTIC_OK) {
+    GArray* bindings = g_hash_table_lookup(Scope, variable->name);
+
+    if (bindings == NULL) {
+        bindings = mem_new_g_array(MemoryNamespaceSet, sizeof(Variable*));
+        g_hash_table_insert(Scope, (gpointer) variable->name, bindings);
+    } else if (bindings->len > 0) {
         print_diagnostic(&variable->nodePtr->location, Error,
                          "Variable already exist: ", variable->name);
         return SEMANTIC_ERROR;
     }
-    GHashTable* currentScope =
-      g_array_index(Scope, GHashTable*, Scope->len - 1);
-    g_hash_table_insert(currentScope, (gpointer) variable->name, variable);
+
+    g_array_append_val(bindings, variable);
+    g_array_append_val(ScopeLog, variable->name);
 
     return SEMANTIC_OK;
 }
@@ -651,17 +756,16 @@ int fillTablesWithVars(GHashTable* variableTable, const GArray* variables) {
 TypeValue createTypeValue(AST_NODE_PTR currentNode) {
     DEBUG("create TypeValue");
     TypeValue value;
-    Type* type    = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    value.type    = type;
-    type->kind    = TypeKindPrimitive;
-    type->nodePtr = currentNode;
+    Type type;
+    type.kind    = TypeKindPrimitive;
+    type.nodePtr = currentNode;
 
     switch (currentNode->kind) {
         case AST_Int:
-            type->impl.primitive = Int;
+            type.impl.primitive = Int;
             break;
         case AST_Float:
-            type->impl.primitive = Float;
+            type.impl.primitive = Float;
             break;
         case AST_Char:
             // validate we have a single UTF-8 codepoint
@@ -670,7 +774,7 @@ TypeValue createTypeValue(AST_NODE_PTR currentNode) {
                                  "Character must be UTF-8 codepoint");
             }
 
-            type->impl.primitive = Char;
+            type.impl.primitive = Char;
             break;
         default:
             PANIC("Node is not an expression but from kind: %i",
@@ -678,18 +782,16 @@ TypeValue createTypeValue(AST_NODE_PTR currentNode) {
             break;
     }
 
+    value.type    = intern_type(&type);
     value.nodePtr = currentNode;
     value.value   = currentNode->value;
     return value;
 }
 
-#define CLONE(x) mem_clone(MemoryNamespaceSet, (void*) &(x), sizeof(x))
-
 TypeValue createString(AST_NODE_PTR currentNode) {
     DEBUG("create String");
     TypeValue value;
-    Type* type    = CLONE(StringLiteralType);
-    value.type    = type;
+    value.type    = intern_type(&StringLiteralType);
     value.nodePtr = currentNode;
     value.value   = currentNode->value;
     return value;
@@ -698,14 +800,14 @@ TypeValue createString(AST_NODE_PTR currentNode) {
 Type* createTypeFromOperands(Type* LeftOperandType, Type* RightOperandType,
                              AST_NODE_PTR currentNode) {
     DEBUG("create type from operands");
-    Type* result    = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    result->nodePtr = currentNode;
+    Type result;
+    result.nodePtr = currentNode;
     DEBUG("LeftOperandType->kind: %i", LeftOperandType->kind);
     DEBUG("RightOperandType->kind: %i", RightOperandType->kind);
 
     if (LeftOperandType->kind == TypeKindComposite
         && RightOperandType->kind == TypeKindComposite) {
-        result->kind = TypeKindComposite;
+        result.kind = TypeKindComposite;
         CompositeType resultImpl;
 
         resultImpl.nodePtr   = currentNode;
@@ -716,45 +818,44 @@ Type* createTypeFromOperands(Type* LeftOperandType, Type* RightOperandType,
         resultImpl.primitive = MAX(LeftOperandType->impl.composite.primitive,
                                    RightOperandType->impl.composite.primitive);
 
-        result->impl.composite = resultImpl;
+        result.impl.composite = resultImpl;
 
     } else if (LeftOperandType->kind == TypeKindPrimitive
                && RightOperandType->kind == TypeKindPrimitive) {
         DEBUG("both operands are primitive");
-        result->kind = TypeKindPrimitive;
+        result.kind = TypeKindPrimitive;
 
-        result->impl.primitive = MAX(LeftOperandType->impl.primitive,
-                                     RightOperandType->impl.primitive);
+        result.impl.primitive = MAX(LeftOperandType->impl.primitive,
+                                    RightOperandType->impl.primitive);
 
     } else if (LeftOperandType->kind == TypeKindPrimitive
                && RightOperandType->kind == TypeKindComposite) {
-        result->kind = TypeKindComposite;
+        result.kind = TypeKindComposite;
 
-        result->impl.composite.sign = Signed;
-        result->impl.composite.scale =
+        result.impl.composite.sign = Signed;
+        result.impl.composite.scale =
           MAX(1.0, RightOperandType->impl.composite.scale);
-        result->impl.composite.primitive =
+        result.impl.composite.primitive =
           MAX(Int, RightOperandType->impl.composite.primitive);
-        result->impl.composite.nodePtr = currentNode;
+        result.impl.composite.nodePtr = currentNode;
 
     } else if (LeftOperandType->kind == TypeKindComposite
                && RightOperandType->kind == TypeKindPrimitive) {
-        result->kind = TypeKindComposite;
+        result.kind = TypeKindComposite;
 
-        result->impl.composite.sign = Signed;
-        result->impl.composite.scale =
+        result.impl.composite.sign = Signed;
+        result.impl.composite.scale =
           MAX(1.0, LeftOperandType->impl.composite.scale);
-        result->impl.composite.primitive =
+        result.impl.composite.primitive =
           MAX(Int, LeftOperandType->impl.composite.primitive);
-        result->impl.composite.nodePtr = currentNode;
+        result.impl.composite.nodePtr = currentNode;
     } else {
-        mem_free(result);
         print_diagnostic(&currentNode->location, Error,
                          "Incompatible types in expression");
         return NULL;
     }
     DEBUG("Succsessfully created type");
-    return result;
+    return intern_type(&result);
 }
 
 int createTypeCastFromExpression(Expression* expression, Type* resultType,
@@ -790,9 +891,9 @@ int createArithOperation(Expression* ParentExpression, AST_NODE_PTR currentNode,
     ParentExpression->impl.operation.operands =
       mem_new_g_array(MemoryNamespaceSet, sizeof(Expression*));
 
-    assert(expectedChildCount == currentNode->children->len);
+    assert(expectedChildCount == currentNode->children.len);
 
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         Expression* expression = createExpression(AST_get_node(currentNode, i));
 
         if (NULL == expression) {
@@ -826,19 +927,24 @@ int createArithOperation(Expression* ParentExpression, AST_NODE_PTR currentNode,
 
     if (ParentExpression->impl.operation.impl.arithmetic == Negate) {
 
-        Type* result = g_array_index(ParentExpression->impl.operation.operands,
-                                     Expression*, 0)
-                         ->result;
-        result->nodePtr = currentNode;
+        Type* operand = g_array_index(ParentExpression->impl.operation.operands,
+                                      Expression*, 0)
+                          ->result;
 
-        if (result->kind == TypeKindReference || result->kind == TypeKindBox) {
+        if (operand->kind == TypeKindReference
+            || operand->kind == TypeKindBox) {
             print_diagnostic(&currentNode->location, Error,
                              "Invalid type for arithmetic operation");
             return SEMANTIC_ERROR;
-        } else if (result->kind == TypeKindComposite) {
-            result->impl.composite.sign = Signed;
         }
-        ParentExpression->result = result;
+
+        // the operand type is shared, negation derives a signed variant
+        Type result    = *operand;
+        result.nodePtr = currentNode;
+        if (result.kind == TypeKindComposite) {
+            result.impl.composite.sign = Signed;
+        }
+        ParentExpression->result = intern_type(&result);
 
     } else {
         Type* LeftOperandType =
@@ -886,7 +992,7 @@ int createRelationalOperation(Expression* ParentExpression,
       mem_new_g_array(MemoryNamespaceSet, sizeof(Expression*));
 
     // fill Operands
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         Expression* expression = createExpression(AST_get_node(currentNode, i));
 
         if (NULL == expression) {
@@ -913,12 +1019,12 @@ int createRelationalOperation(Expression* ParentExpression,
             break;
     }
 
-    Type* result           = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    result->impl.primitive = Int;
-    result->kind           = TypeKindPrimitive;
-    result->nodePtr        = currentNode;
+    Type result;
+    result.impl.primitive = Int;
+    result.kind           = TypeKindPrimitive;
+    result.nodePtr        = currentNode;
 
-    ParentExpression->result = result;
+    ParentExpression->result = intern_type(&result);
 
     for (size_t i = 0; i < ParentExpression->impl.operation.operands->len;
          i++) {
@@ -952,7 +1058,7 @@ int createBoolOperation(Expression* ParentExpression,
       mem_new_g_array(MemoryNamespaceSet, sizeof(Expression*));
 
     // fill Operands
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         Expression* expression = createExpression(AST_get_node(currentNode, i));
         if (NULL == expression) {
             return SEMANTIC_ERROR;
@@ -1066,35 +1172,29 @@ int createBoolNotOperation(Expression* ParentExpression,
       g_array_index(ParentExpression->impl.operation.operands, Expression*, 0)
         ->result;
 
-    Type* result    = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    result->nodePtr = currentNode;
-
     if (Operand->kind == TypeKindBox || Operand->kind == TypeKindReference) {
-        print_diagnostic(&Operand->nodePtr->location, Error,
+        print_diagnostic(&expression->nodePtr->location, Error,
                          "Operand must be a variant of primitive type int");
         return SEMANTIC_ERROR;
     }
 
     if (Operand->kind == TypeKindPrimitive) {
         if (Operand->impl.primitive == Float) {
-            print_diagnostic(&Operand->nodePtr->location, Error,
+            print_diagnostic(&expression->nodePtr->location, Error,
                              "Operand must be a variant of primitive type int");
             return SEMANTIC_ERROR;
         }
-        result->kind = Operand->kind;
-        result->impl = Operand->impl;
 
     } else if (Operand->kind == TypeKindComposite) {
         if (Operand->impl.composite.primitive == Float) {
-            print_diagnostic(&Operand->nodePtr->location, Error,
+            print_diagnostic(&expression->nodePtr->location, Error,
                              "Operand must be a variant of primitive type int");
             return SEMANTIC_ERROR;
         }
-        result->kind = Operand->kind;
-        result->impl = Operand->impl;
     }
 
-    ParentExpression->result = result;
+    // the result has the type of the operand
+    ParentExpression->result = Operand;
 
     for (size_t i = 0; i < ParentExpression->impl.operation.operands->len;
          i++) {
@@ -1129,7 +1229,7 @@ int createBitOperation(Expression* ParentExpression, AST_NODE_PTR currentNode) {
       mem_new_g_array(MemoryNamespaceSet, sizeof(Expression*));
 
     // fill Operands
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         Expression* expression = createExpression(AST_get_node(currentNode, i));
 
         if (NULL == expression) {
@@ -1155,8 +1255,8 @@ int createBitOperation(Expression* ParentExpression, AST_NODE_PTR currentNode) {
             break;
     }
 
-    Type* result    = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    result->nodePtr = currentNode;
+    Type result;
+    result.nodePtr = currentNode;
 
     Expression* lhs =
       g_array_index(ParentExpression->impl.operation.operands, Expression*, 0);
@@ -1196,8 +1296,8 @@ int createBitOperation(Expression* ParentExpression, AST_NODE_PTR currentNode) {
             return SEMANTIC_ERROR;
         }
 
-        result->kind           = TypeKindPrimitive;
-        result->impl.primitive = Int;
+        result.kind           = TypeKindPrimitive;
+        result.impl.primitive = Int;
 
     } else if (LeftOperandType->kind == TypeKindPrimitive
                && RightOperandType->kind == TypeKindComposite) {
@@ -1214,8 +1314,8 @@ int createBitOperation(Expression* ParentExpression, AST_NODE_PTR currentNode) {
             return SEMANTIC_ERROR;
         }
 
-        result->kind           = TypeKindPrimitive;
-        result->impl.primitive = Int;
+        result.kind           = TypeKindPrimitive;
+        result.impl.primitive = Int;
 
     } else if (LeftOperandType->kind == TypeKindComposite
                && RightOperandType->kind == TypeKindPrimitive) {
@@ -1232,8 +1332,8 @@ int createBitOperation(Expression* ParentExpression, AST_NODE_PTR currentNode) {
             return SEMANTIC_ERROR;
         }
 
-        result->kind           = TypeKindPrimitive;
-        result->impl.primitive = Int;
+        result.kind           = TypeKindPrimitive;
+        result.impl.primitive = Int;
     } else {
 
         if (RightOperandType->impl.composite.primitive == Float) {
@@ -1255,15 +1355,16 @@ int createBitOperation(Expression* ParentExpression, AST_NODE_PTR currentNode) {
             return SEMANTIC_ERROR;
         }
 
-        result->kind                   = TypeKindComposite;
-        result->impl.composite.nodePtr = currentNode;
-        result->impl.composite.scale   = LeftOperandType->impl.composite.scale;
-        result->impl.composite.sign =
+        result.kind                     = TypeKindComposite;
+        result.impl.composite.nodePtr   = currentNode;
+        result.impl.composite.primitive = Int;
+        result.impl.composite.scale     = LeftOperandType->impl.composite.scale;
+        result.impl.composite.sign =
           MAX(LeftOperandType->impl.composite.sign,
               RightOperandType->impl.composite.sign);
     }
 
-    ParentExpression->result = result;
+    ParentExpression->result = intern_type(&result);
 
     for (size_t i = 0; i < ParentExpression->impl.operation.operands->len;
          i++) {
@@ -1305,35 +1406,39 @@ int createBitNotOperation(Expression* ParentExpression,
       g_array_index(ParentExpression->impl.operation.operands, Expression*, 0)
         ->result;
 
-    Type* result    = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    result->nodePtr = currentNode;
+    Type result;
+    result.nodePtr = currentNode;
 
     if (Operand->kind == TypeKindPrimitive) {
 
         if (Operand->impl.primitive == Float) {
-            print_diagnostic(&Operand->nodePtr->location, Error,
+            print_diagnostic(&expression->nodePtr->location, Error,
                              "Operand type must be a variant of int");
             return SEMANTIC_ERROR;
         }
 
-        result->kind           = TypeKindPrimitive;
-        result->impl.primitive = Int;
+        result.kind           = TypeKindPrimitive;
+        result.impl.primitive = Int;
     } else if (Operand->kind == TypeKindComposite) {
 
         if (Operand->impl.composite.primitive == Float) {
-            print_diagnostic(&Operand->nodePtr->location, Error,
+            print_diagnostic(&expression->nodePtr->location, Error,
                              "Operand type must be a variant of int");
             return SEMANTIC_ERROR;
         }
 
-        result->kind                     = TypeKindComposite;
-        result->impl.composite.nodePtr   = currentNode;
-        result->impl.composite.primitive = Int;
-        result->impl.composite.sign      = Operand->impl.composite.sign;
-        result->impl.composite.scale     = Operand->impl.composite.scale;
+        result.kind                     = TypeKindComposite;
+        result.impl.composite.nodePtr   = currentNode;
+        result.impl.composite.primitive = Int;
+        result.impl.composite.sign      = Operand->impl.composite.sign;
+        result.impl.composite.scale     = Operand->impl.composite.scale;
+    } else {
+        print_diagnostic(&expression->nodePtr->location, Error,
+                         "Operand type must be a variant of int");
+        return SEMANTIC_ERROR;
     }
 
-    ParentExpression->result = result;
+    ParentExpression->result = intern_type(&result);
 
     for (size_t i = 0; i < ParentExpression->impl.operation.operands->len;
          i++) {
@@ -1437,11 +1542,11 @@ int createBoxAccess(Expression* ParentExpression, AST_NODE_PTR currentNode) {
     // first one is the box itself
     GArray* names = mem_alloc(MemoryNamespaceSet, sizeof(GArray));
     if (currentNode->kind == AST_IdentList) {
-        for (size_t i = 1; i < currentNode->children->len; i++) {
+        for (size_t i = 1; i < currentNode->children.len; i++) {
             g_array_append_val(names, AST_get_node(currentNode, i)->value);
         }
     } else if (currentNode->kind == AST_List) {
-        for (size_t i = 1; i < AST_get_node(currentNode, 1)->children->len;
+        for (size_t i = 1; i < AST_get_node(currentNode, 1)->children.len;
              i++) {
             g_array_append_val(
               names, AST_get_node(AST_get_node(currentNode, 1), i)->value);
@@ -1480,7 +1585,7 @@ int createTypeCast(Expression* ParentExpression, AST_NODE_PTR currentNode) {
         return SEMANTIC_ERROR;
     }
 
-    Type* target = mem_alloc(MemoryNamespaceSet, sizeof(Type));
+    Type* target = NULL;
     int status   = set_get_type_impl(AST_get_node(currentNode, 1), &target);
     if (status) {
         return SEMANTIC_ERROR;
@@ -1499,7 +1604,7 @@ int createTransmute(Expression* ParentExpression, AST_NODE_PTR currentNode) {
         return SEMANTIC_ERROR;
     }
 
-    Type* target = mem_alloc(MemoryNamespaceSet, sizeof(Type));
+    Type* target = NULL;
     int status   = set_get_type_impl(AST_get_node(currentNode, 1), &target);
     if (status) {
         print_diagnostic(&AST_get_node(currentNode, 1)->location, Error,
@@ -1514,7 +1619,7 @@ int createTransmute(Expression* ParentExpression, AST_NODE_PTR currentNode) {
 }
 
 int createDeref(Expression* ParentExpression, AST_NODE_PTR currentNode) {
-    assert(currentNode->children->len == 2);
+    assert(currentNode->children.len == 2);
     Dereference deref;
     deref.nodePtr                = currentNode;
     AST_NODE_PTR expression_node = AST_get_node(currentNode, 1);
@@ -1575,7 +1680,7 @@ int createDeref(Expression* ParentExpression, AST_NODE_PTR currentNode) {
 
 int createAddressOf(Expression* ParentExpression, AST_NODE_PTR currentNode) {
     assert(currentNode != NULL);
-    assert(currentNode->children->len == 1);
+    assert(currentNode->children.len == 1);
 
     AddressOf address_of;
     address_of.node_ptr = currentNode;
@@ -1585,13 +1690,13 @@ int createAddressOf(Expression* ParentExpression, AST_NODE_PTR currentNode) {
         return SEMANTIC_ERROR;
     }
 
-    Type* resultType           = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    resultType->nodePtr        = currentNode;
-    resultType->kind           = TypeKindReference;
-    resultType->impl.reference = address_of.variable->result;
+    Type resultType;
+    resultType.nodePtr        = currentNode;
+    resultType.kind           = TypeKindReference;
+    resultType.impl.reference = address_of.variable->result;
 
     ParentExpression->impl.addressOf = address_of;
-    ParentExpression->result         = resultType;
+    ParentExpression->result         = intern_type(&resultType);
     return SEMANTIC_OK;
 }
 
@@ -1771,48 +1876,22 @@ Expression* createExpression(AST_NODE_PTR currentNode) {
 }
 
 bool compareTypes(Type* leftType, Type* rightType) {
-    if (leftType->kind == TypeKindPrimitive
-        && rightType->kind == TypeKindPrimitive) {
-        return leftType->impl.primitive == rightType->impl.primitive;
+    // types are canonical, equal types share the same instance
+    if (leftType == rightType) {
+        return TRUE;
     }
 
-    if (leftType->kind == TypeKindComposite) {
-        if (rightType->kind == TypeKindPrimitive) {
-            CompositeType leftComposite = leftType->impl.composite;
-
-            if (leftComposite.scale == 1 && leftComposite.sign == Signed) {
-                return leftComposite.primitive == rightType->impl.primitive;
-            }
-
-            return FALSE;
-
-        } else if (rightType->kind == TypeKindComposite) {
-            // Compare composites
+    if (leftType->kind == TypeKindComposite
+        && rightType->kind == TypeKindPrimitive) {
+        CompositeType leftComposite = leftType->impl.composite;
 
-            CompositeType leftComposite  = leftType->impl.composite;
-            CompositeType rightComposite = rightType->impl.composite;
-            if (leftComposite.primitive != rightComposite.primitive) {
-                return FALSE;
-            }
-            if (leftComposite.sign != rightComposite.sign) {
-                return FALSE;
-            }
-            if (leftComposite.scale != rightComposite.scale) {
-                return FALSE;
-            }
-            return TRUE;
+        if (leftComposite.scale == 1 && leftComposite.sign == Signed) {
+            return leftComposite.primitive == rightType->impl.primitive;
         }
 
         return FALSE;
     }
 
-    if (leftType->kind == TypeKindBox && rightType->kind == TypeKindBox) {
-        if (leftType->impl.box != rightType->impl.box) {
-            return FALSE;
-        }
-        return TRUE;
-    }
-
     if (leftType->kind == TypeKindReference
         && rightType->kind == TypeKindReference) {
         bool result =
@@ -1940,11 +2019,9 @@ int fillBlock(Block* block, AST_NODE_PTR currentNode) {
     DEBUG("start filling Block");
     block->nodePtr   = currentNode;
     block->statemnts = mem_new_g_array(MemoryNamespaceSet, sizeof(Statement*));
-    GHashTable* lowerScope =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    g_array_append_val(Scope, lowerScope);
+    enterScope();
 
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         AST_NODE_PTR stmt_node = AST_get_node(currentNode, i);
         int signal             = createStatement(block, stmt_node);
         if (signal) {
@@ -1952,8 +2029,7 @@ int fillBlock(Block* block, AST_NODE_PTR currentNode) {
         }
     }
 
-    mem_free(lowerScope);
-    g_array_remove_index(Scope, Scope->len - 1);
+    leaveScope();
 
     DEBUG("created Block successfully");
     return SEMANTIC_OK;
@@ -2042,7 +2118,7 @@ int createBranch(Statement* ParentStatement, AST_NODE_PTR currentNode) {
     branch.elseBranch.block.statemnts = NULL;
     branch.elseIfBranches             = NULL;
 
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         switch (AST_get_node(currentNode, i)->kind) {
             case AST_If:
                 if (createIf(&branch, AST_get_node(currentNode, i))) {
@@ -2084,7 +2160,7 @@ Parameter get_param_from_func(Function* func, size_t index) {
 
 int createfuncall(FunctionCall* funcall, AST_NODE_PTR currentNode) {
     assert(currentNode != NULL);
-    assert(currentNode->children->len == 2);
+    assert(currentNode->children.len == 2);
 
     AST_NODE_PTR argsListNode = AST_get_node(currentNode, 1);
     AST_NODE_PTR nameNode     = AST_get_node(currentNode, 0);
@@ -2099,17 +2175,19 @@ int createfuncall(FunctionCall* funcall, AST_NODE_PTR currentNode) {
         }
     }
     if (nameNode->kind == AST_IdentList) {
-        assert(nameNode->children->len > 1);
+        assert(nameNode->children.len > 1);
 
         // idents.boxname.funname()
         // only boxname and funname are needed, because the combination is
         // unique
         const char* boxName =
-          AST_get_node(nameNode, (nameNode->children->len - 2))->value;
+          AST_get_node(nameNode, (nameNode->children.len - 2))->value;
         const char* funName =
-          AST_get_node(nameNode, (nameNode->children->len - 1))->value;
+          AST_get_node(nameNode, (nameNode->children.len - 1))->value;
 
-        const char* name = g_strjoin("", boxName, ".", funName, NULL);
+        char* qualified_name = g_strjoin("", boxName, ".", funName, NULL);
+        Symbol name          = symbol_intern(qualified_name);
+        g_free(qualified_name);
 
         int result = getFunction(name, &fun);
         if (result) {
@@ -2130,8 +2208,8 @@ int createfuncall(FunctionCall* funcall, AST_NODE_PTR currentNode) {
     }
 
     size_t count = 0;
-    for (size_t i = 0; i < argsListNode->children->len; i++) {
-        count += AST_get_node(argsListNode, i)->children->len;
+    for (size_t i = 0; i < argsListNode->children.len; i++) {
+        count += AST_get_node(argsListNode, i)->children.len;
     }
 
     if (count != paramCount) {
@@ -2144,10 +2222,10 @@ int createfuncall(FunctionCall* funcall, AST_NODE_PTR currentNode) {
     GArray* expressions =
       mem_new_g_array(MemoryNamespaceSet, (sizeof(Expression*)));
     // exprlists
-    for (size_t i = 0; i < argsListNode->children->len; i++) {
+    for (size_t i = 0; i < argsListNode->children.len; i++) {
         AST_NODE_PTR currentExprList = AST_get_node(argsListNode, i);
 
-        for (int j = ((int) currentExprList->children->len) - 1; j >= 0; j--) {
+        for (int j = ((int) currentExprList->children.len) - 1; j >= 0; j--) {
             AST_NODE_PTR expr_node = AST_get_node(currentExprList, j);
             Expression* expr       = createExpression(expr_node);
             if (expr == NULL) {
@@ -2155,7 +2233,7 @@ int createfuncall(FunctionCall* funcall, AST_NODE_PTR currentNode) {
             }
 
             Parameter param = get_param_from_func(
-              fun, i + currentExprList->children->len - j - 1);
+              fun, i + currentExprList->children.len - j - 1);
 
             if (!compareTypes(expr->result, param.impl.declaration.type)) {
                 print_diagnostic(&expr_node->location, Error,
@@ -2305,7 +2383,7 @@ int createStatement(Block* Parentblock, AST_NODE_PTR currentNode) {
 int createParam(GArray* Paramlist, AST_NODE_PTR currentNode) {
     assert(currentNode->kind == AST_Parameter);
     DEBUG("start param");
-    DEBUG("current node child count: %i", currentNode->children->len);
+    DEBUG("current node child count: %i", currentNode->children.len);
 
     AST_NODE_PTR paramdecl       = AST_get_node(currentNode, 1);
     AST_NODE_PTR ioQualifierList = AST_get_node(currentNode, 0);
@@ -2313,10 +2391,10 @@ int createParam(GArray* Paramlist, AST_NODE_PTR currentNode) {
     ParameterDeclaration decl;
     decl.nodePtr = paramdecl;
 
-    DEBUG("iolistnode child count: %i", ioQualifierList->children->len);
-    if (ioQualifierList->children->len == 2) {
+    DEBUG("iolistnode child count: %i", ioQualifierList->children.len);
+    if (ioQualifierList->children.len == 2) {
         decl.qualifier = InOut;
-    } else if (ioQualifierList->children->len == 1) {
+    } else if (ioQualifierList->children.len == 1) {
         if (strcmp(AST_get_node(ioQualifierList, 0)->value, "in") == 0) {
             decl.qualifier = In;
         } else if (strcmp(AST_get_node(ioQualifierList, 0)->value, "out")
@@ -2375,16 +2453,16 @@ int createFunDef(Function* Parentfunction, AST_NODE_PTR currentNode) {
         return SEMANTIC_ERROR;
     }
 
-    DEBUG("paramlistlist child count: %i", paramlistlist->children->len);
-    for (size_t i = 0; i < paramlistlist->children->len; i++) {
+    DEBUG("paramlistlist child count: %i", paramlistlist->children.len);
+    for (size_t i = 0; i < paramlistlist->children.len; i++) {
 
         // all parameterlists
         AST_NODE_PTR paramlist = AST_get_node(paramlistlist, i);
-        DEBUG("paramlist child count: %i", paramlist->children->len);
-        for (int j = ((int) paramlist->children->len) - 1; j >= 0; j--) {
+        DEBUG("paramlist child count: %i", paramlist->children.len);
+        for (int j = ((int) paramlist->children.len) - 1; j >= 0; j--) {
 
             DEBUG("param child count: %i",
-                  AST_get_node(paramlist, j)->children->len);
+                  AST_get_node(paramlist, j)->children.len);
 
             if (createParam(fundef.parameter, AST_get_node(paramlist, j))) {
                 return SEMANTIC_ERROR;
@@ -2493,16 +2571,16 @@ int createProcDef(Function* Parentfunction, AST_NODE_PTR currentNode) {
     fundef.parameter = mem_new_g_array(MemoryNamespaceSet, sizeof(Parameter));
     fundef.return_value = NULL;
 
-    DEBUG("paramlistlist child count: %i", paramlistlist->children->len);
-    for (size_t i = 0; i < paramlistlist->children->len; i++) {
+    DEBUG("paramlistlist child count: %i", paramlistlist->children.len);
+    for (size_t i = 0; i < paramlistlist->children.len; i++) {
 
         // all parameterlists
         AST_NODE_PTR paramlist = AST_get_node(paramlistlist, i);
-        DEBUG("paramlist child count: %i", paramlist->children->len);
-        for (int j = ((int) paramlist->children->len) - 1; j >= 0; j--) {
+        DEBUG("paramlist child count: %i", paramlist->children.len);
+        for (int j = ((int) paramlist->children.len) - 1; j >= 0; j--) {
 
             DEBUG("param child count: %i",
-                  AST_get_node(paramlist, j)->children->len);
+                  AST_get_node(paramlist, j)->children.len);
 
             if (createParam(fundef.parameter, AST_get_node(paramlist, j))) {
                 return SEMANTIC_ERROR;
@@ -2534,12 +2612,12 @@ int createProcDecl(Function* Parentfunction, AST_NODE_PTR currentNode) {
     fundecl.parameter = mem_new_g_array(MemoryNamespaceSet, sizeof(Parameter));
     fundecl.return_value = NULL;
 
-    for (size_t i = 0; i < paramlistlist->children->len; i++) {
+    for (size_t i = 0; i < paramlistlist->children.len; i++) {
 
         // all parameter lists
         AST_NODE_PTR paramlist = AST_get_node(paramlistlist, i);
 
-        for (int j = ((int) paramlist->children->len) - 1; j >= 0; j--) {
+        for (int j = ((int) paramlist->children.len) - 1; j >= 0; j--) {
             AST_NODE_PTR param = AST_get_node(paramlist, j);
             if (createParam(fundecl.parameter, param)) {
                 return SEMANTIC_ERROR;
@@ -2575,12 +2653,12 @@ int createFunDecl(Function* Parentfunction, AST_NODE_PTR currentNode) {
         return SEMANTIC_ERROR;
     }
 
-    for (size_t i = 0; i < paramlistlist->children->len; i++) {
+    for (size_t i = 0; i < paramlistlist->children.len; i++) {
 
         // all parameter lists
         AST_NODE_PTR paramlist = AST_get_node(paramlistlist, i);
 
-        for (int j = ((int) paramlist->children->len) - 1; j >= 0; j--) {
+        for (int j = ((int) paramlist->children.len) - 1; j >= 0; j--) {
             AST_NODE_PTR param = AST_get_node(paramlist, j);
             if (createParam(fundecl.parameter, param)) {
                 return SEMANTIC_ERROR;
@@ -2597,8 +2675,7 @@ int createFunDecl(Function* Parentfunction, AST_NODE_PTR currentNode) {
 }
 
 int createFunction(Function* function, AST_NODE_PTR currentNode) {
-    functionParameter =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
+    functionParameter = mem_new_symbol_table(MemoryNamespaceSet);
 
     switch (currentNode->kind) {
         case AST_FunDecl:
@@ -2639,14 +2716,14 @@ int createFunction(Function* function, AST_NODE_PTR currentNode) {
 
 int createDeclMember(BoxType* ParentBox, AST_NODE_PTR currentNode) {
 
-    Type* declType = mem_alloc(MemoryNamespaceSet, sizeof(Type));
+    Type* declType = NULL;
     int status     = set_get_type_impl(AST_get_node(currentNode, 0), &declType);
     if (status) {
         return SEMANTIC_ERROR;
     }
 
     AST_NODE_PTR nameList = AST_get_node(currentNode, 1);
-    for (size_t i = 0; i < nameList->children->len; i++) {
+    for (size_t i = 0; i < nameList->children.len; i++) {
         BoxMember* decl  = mem_alloc(MemoryNamespaceSet, sizeof(BoxMember));
         decl->name       = AST_get_node(nameList, i)->value;
         decl->nodePtr    = currentNode;
@@ -2666,7 +2743,7 @@ int createDefMember(BoxType* ParentBox, AST_NODE_PTR currentNode) {
     AST_NODE_PTR expressionNode = AST_get_node(currentNode, 1);
     AST_NODE_PTR nameList       = AST_get_node(declNode, 1);
 
-    Type* declType = mem_alloc(MemoryNamespaceSet, sizeof(Type));
+    Type* declType = NULL;
     int status     = set_get_type_impl(AST_get_node(currentNode, 0), &declType);
     if (status) {
         return SEMANTIC_ERROR;
@@ -2677,7 +2754,7 @@ int createDefMember(BoxType* ParentBox, AST_NODE_PTR currentNode) {
         return SEMANTIC_ERROR;
     }
 
-    for (size_t i = 0; i < nameList->children->len; i++) {
+    for (size_t i = 0; i < nameList->children.len; i++) {
         BoxMember* def  = mem_alloc(MemoryNamespaceSet, sizeof(BoxMember));
         def->box        = ParentBox;
         def->type       = declType;
@@ -2701,10 +2778,12 @@ int createBoxFunction(const char* boxName, Type* ParentBoxType,
         return SEMANTIC_ERROR;
     }
 
-    function->name = g_strjoin("", boxName, ".", function->name, NULL);
+    char* qualified_name = g_strjoin("", boxName, ".", function->name, NULL);
+    function->name       = symbol_intern(qualified_name);
+    g_free(qualified_name);
 
     Parameter param;
-    param.name                       = "self";
+    param.name                       = symbol_intern("self");
     param.nodePtr                    = currentNode;
     param.kind                       = ParameterDeclarationKind;
     param.impl.declaration.qualifier = In;
@@ -2728,11 +2807,14 @@ int createBox(GHashTable* boxes, AST_NODE_PTR currentNode) {
     const char* boxName        = AST_get_node(currentNode, 0)->value;
     AST_NODE_PTR boxMemberList = AST_get_node(currentNode, 1);
 
-    Type* boxType     = mem_alloc(MemoryNamespaceSet, sizeof(Type));
-    boxType->nodePtr  = currentNode;
-    boxType->impl.box = box;
+    Type boxPrototype;
+    boxPrototype.kind     = TypeKindBox;
+    boxPrototype.nodePtr  = currentNode;
+    boxPrototype.impl.box = box;
 
-    for (size_t i = 0; boxMemberList->children->len; i++) {
+    Type* boxType = intern_type(&boxPrototype);
+
+    for (size_t i = 0; boxMemberList->children.len; i++) {
         switch (AST_get_node(boxMemberList, i)->kind) {
             case AST_Decl:
             case AST_Def:
@@ -2765,7 +2847,7 @@ int createTypeDef(GHashTable* types, AST_NODE_PTR currentNode) {
     AST_NODE_PTR typeNode = AST_get_node(currentNode, 0);
     AST_NODE_PTR nameNode = AST_get_node(currentNode, 1);
 
-    Type* type = mem_alloc(MemoryNamespaceSet, sizeof(Type));
+    Type* type = NULL;
     int status = set_get_type_impl(typeNode, &type);
     if (status) {
         return SEMANTIC_ERROR;
@@ -2796,35 +2878,31 @@ int createTypeDef(GHashTable* types, AST_NODE_PTR currentNode) {
 Module* create_set(AST_NODE_PTR currentNode) {
     DEBUG("create root Module");
     // create tables for types
-    declaredComposites =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    declaredBoxes =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    declaredFunctions =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    definedFunctions =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
+    declaredComposites = mem_new_symbol_table(MemoryNamespaceSet);
+    declaredBoxes      = mem_new_symbol_table(MemoryNamespaceSet);
+    declaredFunctions  = mem_new_symbol_table(MemoryNamespaceSet);
+    definedFunctions   = mem_new_symbol_table(MemoryNamespaceSet);
+    canonicalTypes =
+      mem_new_g_hash_table(MemoryNamespaceSet, hash_type, equal_types);
+
+    // builtin types are canonical, this way they can be compared by address
+    g_hash_table_add(canonicalTypes, (gpointer) &ShortShortUnsingedIntType);
+    g_hash_table_add(canonicalTypes, (gpointer) &StringLiteralType);
 
     // create scope
-    Scope = mem_new_g_array(MemoryNamespaceSet, sizeof(GHashTable*));
+    Scope      = mem_new_symbol_table(MemoryNamespaceSet);
+    ScopeLog   = mem_new_g_array(MemoryNamespaceSet, sizeof(const char*));
+    ScopeMarks = mem_new_g_array(MemoryNamespaceSet, sizeof(guint));
 
     // building current scope for module
-    GHashTable* globalscope =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    globalscope =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    g_array_append_val(Scope, globalscope);
+    enterScope();
 
     Module* rootModule = mem_alloc(MemoryNamespaceSet, sizeof(Module));
 
-    GHashTable* boxes =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    GHashTable* types =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    GHashTable* functions =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
-    GHashTable* variables =
-      mem_new_g_hash_table(MemoryNamespaceSet, g_str_hash, g_str_equal);
+    GHashTable* boxes     = mem_new_symbol_table(MemoryNamespaceSet);
+    GHashTable* types     = mem_new_symbol_table(MemoryNamespaceSet);
+    GHashTable* functions = mem_new_symbol_table(MemoryNamespaceSet);
+    GHashTable* variables = mem_new_symbol_table(MemoryNamespaceSet);
     GArray* imports  = mem_new_g_array(MemoryNamespaceSet, sizeof(const char*));
     GArray* includes = mem_new_g_array(MemoryNamespaceSet, sizeof(const char*));
 
@@ -2837,7 +2915,7 @@ Module* create_set(AST_NODE_PTR currentNode) {
 
     DEBUG("created Module struct");
 
-    for (size_t i = 0; i < currentNode->children->len; i++) {
+    for (size_t i = 0; i < currentNode->children.len; i++) {
         DEBUG("created Child with type: %i",
               AST_get_node(currentNode, i)->kind);
         switch (AST_get_node(currentNode, i)->kind) {
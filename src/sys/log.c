@@ -19,12 +19,18 @@ void set_log_level(int level) {
     runtime_log_level = level;
 }
 
-void log_init() {
+void log_configure(void) {
     if (is_option_set("verbose")) {
         set_log_level(LOG_LEVEL_INFORMATION);
     } else if (is_option_set("debug")) {
         set_log_level(LOG_LEVEL_DEBUG);
+    } else {
+        set_log_level(LOG_LEVEL_WARNING);
     }
+}
+
+void log_init() {
+    log_configure();
 
     assert(LOG_DEFAULT_STREAM != NULL);
     log_register_stream(LOG_DEFAULT_STREAM);
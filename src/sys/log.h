@@ -123,6 +123,12 @@ void syslog_panicf(const char* restrict file, unsigned long line,
 void syslog_fatalf(const char* restrict file, unsigned long line,
                    const char* restrict func, const char* restrict format, ...);
 
+/**
+ * @brief Set the runtime log level as requested by the command line options
+ *
+ */
+void log_configure(void);
+
 /**
  * @brief Initialize the logger by registering stderr as stream
  *
@@ -0,0 +1,370 @@
+
+#include <cfg/opt.h>
+#include <io/files.h>
+#include <mem/cache.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/log.h>
+#include <sys/prof.h>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A finished phase.
+ */
+typedef struct ProfileRecord_t {
+    char* name;
+    // NULL if the phase has no subject
+    char* detail;
+    gint64 pid;
+    gint64 thread;
+    // monotonic wall time of the start in microseconds
+    gint64 start;
+    gint64 wall_time;
+    gint64 cpu_time;
+    // peak resident memory of the process at the end in KiB
+    gint64 peak_rss;
+    gint64 allocations;
+} ProfileRecord;
+
+/**
+ * @brief Sum of all records of the same phase.
+ */
+typedef struct ProfileSummary_t {
+    const char* name;
+    guint count;
+    gint64 wall_time;
+    gint64 cpu_time;
+    gint64 peak_rss;
+    gint64 allocations;
+} ProfileSummary;
+
+// records are kept in plain GLib memory so that the profiler does not
+// count its own allocations
+static GArray* records = NULL;
+static GMutex prof_lock;
+static bool enabled = false;
+
+// threads are numbered in order of their first phase
+static GPrivate thread_id;
+static gint thread_count = 0;
+
+static void clear_record(gpointer data) {
+    ProfileRecord* record = data;
+
+    g_free(record->name);
+    g_free(record->detail);
+}
+
+static gint64 get_thread_id(void) {
+    gint id = GPOINTER_TO_INT(g_private_get(&thread_id));
+
+    if (id == 0) {
+        id = g_atomic_int_add(&thread_count, 1) + 1;
+        g_private_set(&thread_id, GINT_TO_POINTER(id));
+    }
+
+    return id;
+}
+
+static gint64 get_process_id(void) {
+#ifdef __unix__
+    return getpid();
+#else
+    return 0;
+#endif
+}
+
+static gint64 get_thread_cpu_time(void) {
+#ifdef __unix__
+    struct timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0) {
+        return (gint64) time.tv_sec * G_USEC_PER_SEC + time.tv_nsec / 1000;
+    }
+#endif
+
+    return 0;
+}
+
+static gint64 get_peak_rss(void) {
+#ifdef __unix__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+#endif
+
+    return 0;
+}
+
+void prof_init(void) {
+    g_mutex_lock(&prof_lock);
+
+    if (records == NULL) {
+        records = g_array_new(FALSE, FALSE, sizeof(ProfileRecord));
+        g_array_set_clear_func(records, clear_record);
+    }
+    g_array_set_size(records, 0);
+
+    enabled = is_option_set("time-report") || is_option_set("time-trace");
+
+    g_mutex_unlock(&prof_lock);
+}
+
+bool prof_is_enabled(void) {
+    return enabled;
+}
+
+ProfilePhase prof_begin(const char* name, const char* detail) {
+    ProfilePhase phase;
+    phase.name   = NULL;
+    phase.detail = detail;
+
+    if (enabled) {
+        phase.name              = name;
+        phase.start             = g_get_monotonic_time();
+        phase.cpu_start         = get_thread_cpu_time();
+        phase.allocations_start = mem_get_allocation_count();
+    }
+
+    return phase;
+}
+
+void prof_end(ProfilePhase* phase) {
+    if (phase->name == NULL) {
+        return;
+    }
+
+    ProfileRecord record;
+    record.name        = g_strdup(phase->name);
+    record.detail      = g_strdup(phase->detail);
+    record.pid         = get_process_id();
+    record.thread      = get_thread_id();
+    record.start       = phase->start;
+    record.wall_time   = g_get_monotonic_time() - phase->start;
+    record.cpu_time    = get_thread_cpu_time() - phase->cpu_start;
+    record.peak_rss    = get_peak_rss();
+    record.allocations =
+      (gint64) (mem_get_allocation_count() - phase->allocations_start);
+
+    g_mutex_lock(&prof_lock);
+    g_array_append_val(records, record);
+    g_mutex_unlock(&prof_lock);
+
+    phase->name = NULL;
+}
+
+void prof_write_records(FILE* file) {
+    const gint64 pid = get_process_id();
+
+    g_mutex_lock(&prof_lock);
+
+    for (guint i = 0; records != NULL && i < records->len; i++) {
+        const ProfileRecord* record = &g_array_index(records, ProfileRecord, i);
+
+        // records inherited from the parent process are already known
+        if (record->pid != pid) {
+            continue;
+        }
+
+        fprintf(file,
+                "%s\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT
+                "\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT
+                "\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT
+                "\t%" G_GINT64_FORMAT "\t%s\n",
+                record->name, record->pid, record->thread, record->start,
+                record->wall_time, record->cpu_time, record->peak_rss,
+                record->allocations,
+                record->detail == NULL ? "" : record->detail);
+    }
+
+    g_mutex_unlock(&prof_lock);
+
+    fflush(file);
+}
+
+void prof_read_records(FILE* file) {
+    char* line  = NULL;
+    size_t size = 0;
+
+    rewind(file);
+    while (getline(&line, &size, file) > 0) {
+        line[strcspn(line, "\n")] = 0;
+
+        gchar** fields = g_strsplit(line, "\t", 9);
+
+        if (g_strv_length(fields) == 9) {
+            ProfileRecord record;
+            record.name        = g_strdup(fields[0]);
+            record.pid         = g_ascii_strtoll(fields[1], NULL, 10);
+            record.thread      = g_ascii_strtoll(fields[2], NULL, 10);
+            record.start       = g_ascii_strtoll(fields[3], NULL, 10);
+            record.wall_time   = g_ascii_strtoll(fields[4], NULL, 10);
+            record.cpu_time    = g_ascii_strtoll(fields[5], NULL, 10);
+            record.peak_rss    = g_ascii_strtoll(fields[6], NULL, 10);
+            record.allocations = g_ascii_strtoll(fields[7], NULL, 10);
+            record.detail      = NULL;
+
+            if (fields[8][0] != 0) {
+                record.detail = g_strdup(fields[8]);
+            }
+
+            g_mutex_lock(&prof_lock);
+            g_array_append_val(records, record);
+            g_mutex_unlock(&prof_lock);
+        }
+
+        g_strfreev(fields);
+    }
+    free(line);
+}
+
+static void print_time_report(void) {
+    GArray* summaries = g_array_new(FALSE, FALSE, sizeof(ProfileSummary));
+    // maps phase names to their index in summaries
+    GHashTable* indices = g_hash_table_new(g_str_hash, g_str_equal);
+
+    for (guint i = 0; i < records->len; i++) {
+        const ProfileRecord* record = &g_array_index(records, ProfileRecord, i);
+
+        gpointer index = NULL;
+        if (!g_hash_table_lookup_extended(indices, record->name, NULL,
+                                          &index)) {
+            ProfileSummary summary;
+            summary.name        = record->name;
+            summary.count       = 0;
+            summary.wall_time   = 0;
+            summary.cpu_time    = 0;
+            summary.peak_rss    = 0;
+            summary.allocations = 0;
+
+            index = GUINT_TO_POINTER(summaries->len);
+            g_array_append_val(summaries, summary);
+            g_hash_table_insert(indices, record->name, index);
+        }
+
+        ProfileSummary* summary =
+          &g_array_index(summaries, ProfileSummary, GPOINTER_TO_UINT(index));
+        summary->count++;
+        summary->wall_time += record->wall_time;
+        summary->cpu_time += record->cpu_time;
+        summary->peak_rss = MAX(summary->peak_rss, record->peak_rss);
+        summary->allocations += record->allocations;
+    }
+
+    printf("Time report (nested phases are included in their parent):\n");
+    printf("%-24s %6s %12s %12s %14s %12s\n", "Phase", "Count", "Wall (ms)",
+           "CPU (ms)", "Peak RSS (KiB)", "Allocations");
+
+    for (guint i = 0; i < summaries->len; i++) {
+        const ProfileSummary* summary =
+          &g_array_index(summaries, ProfileSummary, i);
+
+        printf("%-24s %6u %12.3f %12.3f %14" G_GINT64_FORMAT
+               " %12" G_GINT64_FORMAT "\n",
+               summary->name, summary->count, summary->wall_time / 1000.0,
+               summary->cpu_time / 1000.0, summary->peak_rss,
+               summary->allocations);
+    }
+
+    g_hash_table_destroy(indices);
+    g_array_free(summaries, TRUE);
+}
+
+static void append_json_string(GString* json, const char* string) {
+    g_string_append_c(json, '"');
+
+    for (const char* c = string; *c != 0; c++) {
+        if (*c == '"' || *c == '\\') {
+            g_string_append_c(json, '\\');
+            g_string_append_c(json, *c);
+        } else if ((unsigned char) *c < 0x20) {
+            g_string_append_printf(json, "\\u%04x", (unsigned char) *c);
+        } else {
+            g_string_append_c(json, *c);
+        }
+    }
+
+    g_string_append_c(json, '"');
+}
+
+static int write_time_trace(const char* path) {
+    GString* json = g_string_new("{\"traceEvents\":[\n");
+
+    for (guint i = 0; i < records->len; i++) {
+        const ProfileRecord* record = &g_array_index(records, ProfileRecord, i);
+
+        if (i > 0) {
+            g_string_append(json, ",\n");
+        }
+
+        g_string_append(json, "{\"name\":");
+        append_json_string(json, record->name);
+        g_string_append_printf(
+          json,
+          ",\"cat\":\"gsc\",\"ph\":\"X\",\"pid\":%" G_GINT64_FORMAT
+          ",\"tid\":%" G_GINT64_FORMAT ",\"ts\":%" G_GINT64_FORMAT
+          ",\"dur\":%" G_GINT64_FORMAT ",\"args\":{\"cpu_us\":%" G_GINT64_FORMAT
+          ",\"peak_rss_kib\":%" G_GINT64_FORMAT
+          ",\"allocations\":%" G_GINT64_FORMAT,
+          record->pid, record->thread, record->start, record->wall_time,
+          record->cpu_time, record->peak_rss, record->allocations);
+
+        if (record->detail != NULL) {
+            g_string_append(json, ",\"detail\":");
+            append_json_string(json, record->detail);
+        }
+
+        g_string_append(json, "}}");
+    }
+
+    g_string_append(json, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    int status    = EXIT_SUCCESS;
+    GError* error = NULL;
+    if (!g_file_set_contents(path, json->str, (gssize) json->len, &error)) {
+        print_message(Error, "Unable to write time trace %s: %s", path,
+                      error->message);
+        g_error_free(error);
+        status = EXIT_FAILURE;
+    } else {
+        print_message(Info, "Time trace was written to: %s", path);
+    }
+
+    g_string_free(json, TRUE);
+
+    return status;
+}
+
+int prof_report(void) {
+    if (!enabled) {
+        return EXIT_SUCCESS;
+    }
+
+    int status = EXIT_SUCCESS;
+
+    g_mutex_lock(&prof_lock);
+
+    if (is_option_set("time-report")) {
+        print_time_report();
+    }
+
+    if (is_option_set("time-trace")) {
+        const Option* opt = get_option("time-trace");
+
+        if (opt->value != NULL) {
+            status = write_time_trace(opt->value);
+        } else {
+            print_message(Error, "No file given to write the time trace to");
+            status = EXIT_FAILURE;
+        }
+    }
+
+    g_mutex_unlock(&prof_lock);
+
+    return status;
+}
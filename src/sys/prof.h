@@ -0,0 +1,79 @@
+//
+// Phase profiler. Records wall time, CPU time, peak resident memory and
+// allocations of the phases of a build. Enabled by --time-report, which
+// prints a summary table, and --time-trace=file, which writes the phases
+// in the Chrome trace event format.
+//
+
+#ifndef GEMSTONE_PROF_H
+#define GEMSTONE_PROF_H
+
+#include <glib.h>
+#include <stdio.h>
+
+/**
+ * @brief A phase which has been started but not ended yet.
+ */
+typedef struct ProfilePhase_t {
+    // name of the phase, NULL if profiling is disabled
+    const char* name;
+    // optional subject of the phase like a file or unit name
+    const char* detail;
+    // monotonic wall time in microseconds
+    gint64 start;
+    // CPU time of the calling thread in microseconds
+    gint64 cpu_start;
+    size_t allocations_start;
+} ProfilePhase;
+
+/**
+ * @brief Enable the profiler if requested by the options and discard all
+ *        phases recorded before.
+ */
+void prof_init(void);
+
+/**
+ * @brief Check whether phases are recorded.
+ * @return
+ */
+bool prof_is_enabled(void);
+
+/**
+ * @brief Start a new phase. May be called from any thread.
+ * @param name static name of the phase
+ * @param detail optional subject of the phase, copied once the phase ends
+ * @return the phase which must be passed to prof_end()
+ */
+[[gnu::nonnull(1)]]
+ProfilePhase prof_begin(const char* name, const char* detail);
+
+/**
+ * @brief End a phase and record it.
+ * @param phase
+ */
+[[gnu::nonnull(1)]]
+void prof_end(ProfilePhase* phase);
+
+/**
+ * @brief Write all phases recorded by this process to a file.
+ *        Used to pass the phases of worker processes to their parent.
+ * @param file
+ */
+[[gnu::nonnull(1)]]
+void prof_write_records(FILE* file);
+
+/**
+ * @brief Read phases written by prof_write_records().
+ * @param file
+ */
+[[gnu::nonnull(1)]]
+void prof_read_records(FILE* file);
+
+/**
+ * @brief Print the summary table and write the trace file as requested
+ *        by the options.
+ * @return EXIT_SUCCESS if successful EXIT_FAILURE otherwise
+ */
+int prof_report(void);
+
+#endif // GEMSTONE_PROF_H
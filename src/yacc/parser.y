@@ -1,28 +1,35 @@
 %locations
+%define api.pure full
 %define parse.error verbose
 
+%parse-param {void* scanner} {ParseContext* context}
+%lex-param {void* scanner}
+
 %code requires {
     #include <sys/log.h>
     #include <ast/ast.h>
     #include <sys/col.h>
     #include <io/files.h>
     #include <glib.h>
-    extern int yylineno;
-    extern ModuleFile* current_file;
 
-    int yyerror(const char*);
+    typedef struct ParseContext_t ParseContext;
+
+    #define new_loc() new_location(yylloc.first_line, yylloc.first_column, yylloc.last_line, yylloc.last_column, context->file)
+}
+
+%code provides {
+    int yylex(YYSTYPE*, YYLTYPE*, void*);
 
-    extern char* buffer;
-    extern int yylineno;
-    
-    extern int yylex();
-    extern AST_NODE_PTR root;
+    int yyerror(YYLTYPE*, void*, ParseContext*, const char*);
+}
 
-    #define new_loc() new_location(yylloc.first_line, yylloc.first_column, yylloc.last_line, yylloc.last_column, current_file)
+%code {
+    #include <lex/util.h>
+    #include <mem/symbol.h>
 }
 
 %union {
-    char *string;
+    const char *string;
     AST_NODE_PTR node_ptr;
 }
 
@@ -145,9 +152,9 @@
 %left '(' ')' '[' ']'
 
 %%
-program: program programbody {AST_push_node(root, $2); 
+program: program programbody {AST_push_node(context->root, $2); 
                               }
-       | programbody {AST_push_node(root, $1);};
+       | programbody {AST_push_node(context->root, $1);};
 
 programbody: moduleimport {$$ = $1;}
        | moduleinclude {$$ = $1;}
@@ -304,7 +311,7 @@ boxcontent: decl { $$ = $1;DEBUG("Box decl Content"); }
           | fundef { $$ = $1;DEBUG("Box fun Content"); };
 
 boxselfaccess: KeySelf '.' Ident {AST_NODE_PTR boxselfaccess = AST_new_node(new_loc(), AST_List, NULL);
-                                      AST_NODE_PTR self = AST_new_node(new_loc(), AST_Ident, "self");
+                                      AST_NODE_PTR self = AST_new_node(new_loc(), AST_Ident, symbol_intern("self"));
                                       AST_push_node(boxselfaccess, self);
                                       AST_NODE_PTR identlist = AST_new_node(new_loc(), AST_IdentList, NULL);
                                       AST_NODE_PTR ident = AST_new_node(new_loc(), AST_Ident, $3);
@@ -312,7 +319,7 @@ boxselfaccess: KeySelf '.' Ident {AST_NODE_PTR boxselfaccess = AST_new_node(new_
                                       AST_push_node(boxselfaccess, identlist);
                                       $$ = boxselfaccess;}
              | KeySelf '.' boxaccess {AST_NODE_PTR boxselfaccess = AST_new_node(new_loc(), AST_List, NULL);
-                                      AST_NODE_PTR self = AST_new_node(new_loc(), AST_Ident, "self");
+                                      AST_NODE_PTR self = AST_new_node(new_loc(), AST_Ident, symbol_intern("self"));
                                       AST_push_node(boxselfaccess, self);
                                       AST_push_node(boxselfaccess, $3);
                                       $$ = boxselfaccess;};
@@ -492,8 +499,8 @@ scale: scale KeyShort {AST_NODE_PTR shortnode = AST_new_node(new_loc(), AST_Scal
                 $$ = scale;};
 
 typekind: Ident {$$ = AST_new_node(new_loc(), AST_Typekind, $1);}
-    | KeyInt {$$ = AST_new_node(new_loc(), AST_Typekind, "int");}
-    | KeyFloat {$$ = AST_new_node(new_loc(), AST_Typekind, "float");};
+    | KeyInt {$$ = AST_new_node(new_loc(), AST_Typekind, symbol_intern("int"));}
+    | KeyFloat {$$ = AST_new_node(new_loc(), AST_Typekind, symbol_intern("float"));};
 
 type: typekind {AST_NODE_PTR type = AST_new_node(new_loc(), AST_Type, NULL);
                 AST_push_node(type, $1);
@@ -586,8 +593,8 @@ opbit: expr OpBitand expr {AST_NODE_PTR and = AST_new_node(new_loc(), AST_BitAnd
                              $$ = not;};
 %%
 
-int yyerror(const char *s) {
-    TokenLocation location = new_loc();
+int yyerror(YYLTYPE* yylloc, [[maybe_unused]] void* scanner, ParseContext* context, const char *s) {
+    TokenLocation location = new_location(yylloc->first_line, yylloc->first_column, yylloc->last_line, yylloc->last_column, context->file);
     print_diagnostic(&location, Error, s);
     return 0;
-}
\ No newline at end of file
+}
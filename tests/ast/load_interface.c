@@ -0,0 +1,146 @@
+#include <ast/ast.h>
+#include <cfg/opt.h>
+#include <glib/gstdio.h>
+#include <io/interface.h>
+#include <io/manifest.h>
+#include <mem/cache.h>
+#include <string.h>
+#include <sys/col.h>
+#include <sys/log.h>
+
+#define SOURCE_PATH "tmp/interface.gsc"
+
+// nesting of the tree beyond the depth accepted when loading
+#define DEEP_NESTING 5000
+
+static AST_NODE_PTR new_node(ModuleFile* file, enum AST_SyntaxElement_t kind,
+                             const char* value, unsigned int line) {
+    return AST_new_node(new_location(line, 1, line, 8, file), kind, value);
+}
+
+static AST_NODE_PTR build_module(ModuleFile* file) {
+    const AST_NODE_PTR module = new_node(file, AST_Module, NULL, 0);
+
+    const AST_NODE_PTR add = new_node(file, AST_Add, NULL, 1);
+    AST_push_node(add, new_node(file, AST_Int, "3", 1));
+    AST_push_node(add, new_node(file, AST_Ident, "x", 2));
+
+    const AST_NODE_PTR stmt = new_node(file, AST_Stmt, NULL, 1);
+    AST_push_node(stmt, add);
+
+    AST_push_node(module, stmt);
+    AST_push_node(module, new_node(file, AST_Ident, "x", 3));
+
+    return module;
+}
+
+static bool equal_trees(const AST_NODE_PTR a, const AST_NODE_PTR b) {
+    if (a->kind != b->kind || (a->value == NULL) != (b->value == NULL)
+        || (a->value != NULL && strcmp(a->value, b->value) != 0)
+        || a->location.line_start != b->location.line_start
+        || a->location.col_end != b->location.col_end
+        || AST_get_child_count(a) != AST_get_child_count(b)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < AST_get_child_count(a); i++) {
+        if (!equal_trees(AST_get_node(a, i), AST_get_node(b, i))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool load(ModuleFile* file, AST_NODE_PTR* loaded) {
+    *loaded = new_node(file, AST_Module, NULL, 0);
+
+    return interface_load(*loaded, file);
+}
+
+int main(int argc, char* argv[]) {
+    mem_init();
+    parse_options(argc, argv);
+    log_init();
+    col_init();
+
+    g_mkdir_with_parents("tmp", 0755);
+    if (!g_file_set_contents(SOURCE_PATH, "x = 3 + x", -1, NULL)) {
+        return 1;
+    }
+
+    ModuleFileStack files = new_file_stack();
+    ModuleFile* file      = push_file(&files, SOURCE_PATH);
+    file->digest          = manifest_file_digest(SOURCE_PATH);
+
+    // write and load the same tree
+    const AST_NODE_PTR module = build_module(file);
+    if (interface_write(module, file) != EXIT_SUCCESS) {
+        return 1;
+    }
+
+    AST_NODE_PTR loaded = NULL;
+    if (!load(file, &loaded) || !equal_trees(module, loaded)) {
+        return 1;
+    }
+
+    // a truncated interface falls back to parsing
+    char* path     = interface_path(SOURCE_PATH);
+    gchar* content = NULL;
+    gsize length   = 0;
+    if (!g_file_get_contents(path, &content, &length, NULL)
+        || !g_file_set_contents(path, content, (gssize) length - 5, NULL)) {
+        return 1;
+    }
+    g_free(content);
+
+    AST_NODE_PTR truncated = NULL;
+    if (load(file, &truncated) || AST_get_child_count(truncated) != 0) {
+        return 1;
+    }
+
+    // interfaces of another version of the source are ignored
+    g_free(file->digest);
+    file->digest = manifest_data_digest("x = 4", 5);
+
+    AST_NODE_PTR changed = NULL;
+    if (interface_write(module, file) != EXIT_SUCCESS) {
+        return 1;
+    }
+    g_free(file->digest);
+    file->digest = manifest_file_digest(SOURCE_PATH);
+    if (load(file, &changed)) {
+        return 1;
+    }
+
+    // nesting too deep is rejected instead of exhausting the stack
+    AST_NODE_PTR deep      = new_node(file, AST_Module, NULL, 0);
+    AST_NODE_PTR innermost = deep;
+    for (int i = 0; i < DEEP_NESTING; i++) {
+        const AST_NODE_PTR child = new_node(file, AST_Stmt, NULL, 1);
+        AST_push_node(innermost, child);
+        innermost = child;
+    }
+    if (interface_write(deep, file) != EXIT_SUCCESS) {
+        return 1;
+    }
+
+    AST_NODE_PTR deep_loaded = NULL;
+    if (load(file, &deep_loaded)) {
+        return 1;
+    }
+
+    g_remove(path);
+    g_remove(SOURCE_PATH);
+    g_free(path);
+
+    AST_delete_node(module);
+    AST_delete_node(loaded);
+    AST_delete_node(truncated);
+    AST_delete_node(changed);
+    AST_delete_node(deep);
+    AST_delete_node(deep_loaded);
+    delete_files(&files);
+
+    return 0;
+}
@@ -132,6 +132,25 @@ def run_check_print_graphviz():
         assert "if" in string
 
 
+def run_check_load_interface():
+    info("started check load interface...")
+
+    info("creating temporary folder...")
+
+    if not os.path.exists("tmp"):
+        os.makedirs("tmp", exist_ok=True)
+
+    p = subprocess.run(BIN_DIR + "load_interface", capture_output=True, text=True)
+
+    info("checking exit code...")
+
+    # check exit code
+    assert p.returncode == 0
+
+    info("checking fallback on malformed interfaces...")
+    assert "malformed module interface" in p.stderr
+
+
 if __name__ == "__main__":
     logging.basicConfig(level=logging.INFO)
 
@@ -146,6 +165,8 @@ if __name__ == "__main__":
             run_check_print_node()
         case "check_print_graphviz":
             run_check_print_graphviz()
+        case "check_load_interface":
+            run_check_load_interface()
         case _:
             error(f"unknown target: {target}")
             exit(1)
@@ -6,6 +6,19 @@
 #include <sys/col.h>
 #include <cfg/opt.h>
 #include <mem/cache.h>
+#include <string.h>
+
+#define THREAD_COUNT            4
+#define THREAD_ALLOCATION_COUNT 10000
+
+static gpointer allocate_blocks(gpointer data) {
+    for (int i = 0; i < THREAD_ALLOCATION_COUNT; i++) {
+        char* block = mem_alloc(MemoryNamespaceAst, 24);
+        memset(block, i, 24);
+    }
+
+    return data;
+}
 
 int main(int argc, char* argv[]) {
     mem_init();
@@ -20,6 +33,45 @@ int main(int argc, char* argv[]) {
         mem_free(data);
     }
 
+    // arena namespace: bump allocations, in place growth and large blocks
+    char* first = mem_alloc(MemoryNamespaceLex, 16);
+    first       = mem_realloc(MemoryNamespaceLex, first, 64);
+    char* large = mem_alloc(MemoryNamespaceLex, 1024 * 1024);
+    memset(first, 0, 64);
+    memset(large, 0, 1024 * 1024);
+    char* copy = mem_strdup(MemoryNamespaceLex, "arena");
+    if (strcmp(copy, "arena") != 0) {
+        return 1;
+    }
+    mem_purge_namespace(MemoryNamespaceLex);
+
+    // arena namespaces serve every thread from its own slab
+    const size_t allocations = mem_get_allocation_count();
+    GThread* threads[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        threads[i] = g_thread_new("arena", allocate_blocks, NULL);
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        g_thread_join(threads[i]);
+    }
+    if (mem_get_allocation_count() - allocations
+        != THREAD_COUNT * THREAD_ALLOCATION_COUNT) {
+        return 1;
+    }
+    mem_purge_namespace(MemoryNamespaceAst);
+
+    // generic namespace: individually freed and reallocated blocks
+    void* blocks[64];
+    for (int i = 0; i < 64; i++) {
+        blocks[i] = mem_alloc(MemoryNamespaceIo, 32);
+    }
+    for (int i = 0; i < 64; i += 2) {
+        blocks[i] = mem_realloc(MemoryNamespaceIo, blocks[i], 4096);
+        mem_free(blocks[i]);
+    }
+    mem_free_from(MemoryNamespaceIo, blocks[1]);
+    mem_purge_namespace(MemoryNamespaceIo);
+
     mem_purge_namespace(MemoryNamespaceOpt);
 
     print_memory_statistics();
@@ -0,0 +1,41 @@
+#include <cfg/opt.h>
+#include <mem/cache.h>
+#include <mem/symbol.h>
+#include <string.h>
+#include <sys/col.h>
+#include <sys/log.h>
+
+int main(int argc, char* argv[]) {
+    mem_init();
+    parse_options(argc, argv);
+    log_init();
+    set_log_level(LOG_LEVEL_DEBUG);
+    col_init();
+
+    char buffer[] = "main.x";
+
+    Symbol main = symbol_intern("main");
+    Symbol x    = symbol_intern("x");
+
+    // same content yields the same symbol, regardless of the source
+    if (symbol_intern_length(buffer, 4) != main
+        || symbol_intern(buffer + 5) != x || main == x) {
+        return 1;
+    }
+
+    if (strcmp(main, "main") != 0
+        || symbol_hash(main) != symbol_hash(symbol_intern("main"))) {
+        return 1;
+    }
+
+    GHashTable* table = mem_new_symbol_table(MemoryNamespaceSet);
+    g_hash_table_insert(table, (gpointer) main, (gpointer) x);
+
+    if (g_hash_table_lookup(table, symbol_intern_length(buffer, 4)) != x) {
+        return 1;
+    }
+
+    mem_purge_namespace(MemoryNamespaceSet);
+
+    return 0;
+}
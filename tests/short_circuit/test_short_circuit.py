@@ -0,0 +1,43 @@
+import os.path
+import subprocess
+import logging
+from logging import info
+
+
+def check_build_and_run():
+    info("testing compilation of short circuit operators...")
+
+    p = subprocess.run(["../../bin/check/gsc", "build", "release", "--verbose"], capture_output=True, text=True)
+
+    print(p.stdout)
+
+    assert p.returncode == 0
+
+    p = subprocess.run(["bin/release.out"], capture_output=True, text=True)
+
+    print(p.stdout)
+
+    assert p.returncode == 0
+
+    info("checking which operands were evaluated...")
+
+    # right operands only run if the left one does not decide the result
+    assert "or lhs" in p.stdout
+    assert "or rhs" not in p.stdout
+    assert "and lhs" in p.stdout
+    assert "and rhs" in p.stdout
+    assert "zero lhs" in p.stdout
+    assert "zero rhs" not in p.stdout
+
+    info("checking results...")
+
+    assert "or is 1" in p.stdout
+    assert "and is 1" in p.stdout
+    assert "zero is 0" in p.stdout
+
+if __name__ == "__main__":
+    logging.basicConfig(level=logging.INFO)
+    info("check if binary exists...")
+    assert os.path.exists("../../bin/check/gsc")
+
+    check_build_and_run()